@@ -0,0 +1,47 @@
+#include "core/Grid.h"
+#include "factory/SolverFactory.h"
+#include "utils/Config.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace slitherlink;
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || string(argv[1]) == "--help")
+    {
+        cerr << "Usage: " << argv[0] << " <inputfile> [--all] [options]\n";
+        return 1;
+    }
+    string filename = argv[1];
+
+    try
+    {
+        SolverConfig config = SolverConfig::fromCommandLine(argc, argv);
+        Grid grid;
+        if (!grid.loadFromFile(filename))
+        {
+            cerr << "Error: could not read puzzle " << filename << "\n";
+            return 1;
+        }
+        // The search instantiated for the configured heuristic and passes
+        auto solver = SolverFactory::createEngine(grid, config);
+
+        auto start = chrono::steady_clock::now();
+        solver->solve(config.findAll);
+        auto end = chrono::steady_clock::now();
+        double seconds = chrono::duration_cast<chrono::duration<double>>(end - start).count();
+
+        solver->printSolutions();
+        cout << "Time: " << seconds << " s\n";
+    }
+    catch (const exception &e)
+    {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
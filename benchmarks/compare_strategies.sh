@@ -0,0 +1,91 @@
+#!/bin/bash
+# Compare search strategies of the Slitherlink solver on every sample tier
+#
+# Usage: compare_strategies.sh heuristic|branching [solver] [timeout]
+#   heuristic - first-solution time of --heuristic score, smart and activity
+#   branching - search nodes of --branching edge and pattern, first solution
+#               and all solutions
+
+MODE=${1:-heuristic}
+SOLVER=${2:-"./cmake-build-debug/slitherlink"}
+TIMEOUT=${3:-30}
+PUZZLES_DIR="puzzles/samples"
+RESULTS_FILE="strategy_results.txt"
+
+if [ ! -x "$SOLVER" ]; then
+    echo "Solver not found: $SOLVER" >&2
+    exit 1
+fi
+
+# Every sample, smallest tier first
+puzzles=$(find "$PUZZLES_DIR" -name '*.txt' | awk -F/ '{print $NF, $0}' | sort -V | cut -d' ' -f2)
+
+# Prints the solver's time for one puzzle, or "timeout"
+run_time() {
+    local puzzle=$1
+    shift
+    local output
+    output=$(timeout "$TIMEOUT" "$SOLVER" "$puzzle" --no-parallel "$@" 2>&1)
+    if [ $? -eq 124 ]; then
+        echo "timeout"
+    else
+        echo "$output" | grep "Time:" | awk '{printf "%.3f", $2}'
+    fi
+}
+
+# Prints the solver's search node count for one puzzle, "timeout", or "-"
+# when presolve settles the puzzle without a search
+run_nodes() {
+    local puzzle=$1
+    shift
+    local output
+    output=$(timeout "$TIMEOUT" "$SOLVER" "$puzzle" --no-parallel -v "$@" 2>&1)
+    if [ $? -eq 124 ]; then
+        echo "timeout"
+    else
+        local nodes
+        nodes=$(echo "$output" | grep "^Search:" | awk '{print $2}')
+        echo "${nodes:--}"
+    fi
+}
+
+compare_heuristics() {
+    printf "%-28s %10s %10s %10s\n" "Puzzle" "score" "smart" "activity" | tee -a "$RESULTS_FILE"
+    for puzzle in $puzzles; do
+        row=$(printf "%-28s" "$(basename "$puzzle" .txt)")
+        for heuristic in score smart activity; do
+            row+=$(printf " %10s" "$(run_time "$puzzle" --heuristic "$heuristic")")
+        done
+        echo "$row" | tee -a "$RESULTS_FILE"
+    done
+}
+
+compare_branching() {
+    printf "%-28s %10s %10s %12s %12s\n" "Puzzle" "edge" "pattern" "edge --all" "pattern --all" | tee -a "$RESULTS_FILE"
+    for puzzle in $puzzles; do
+        row=$(printf "%-28s" "$(basename "$puzzle" .txt)")
+        for branching in edge pattern; do
+            row+=$(printf " %10s" "$(run_nodes "$puzzle" --branching "$branching")")
+        done
+        for branching in edge pattern; do
+            row+=$(printf " %12s" "$(run_nodes "$puzzle" --branching "$branching" --all)")
+        done
+        echo "$row" | tee -a "$RESULTS_FILE"
+    done
+}
+
+echo "=== Slitherlink Strategy Comparison ($MODE, ${TIMEOUT}s timeout) ===" | tee "$RESULTS_FILE"
+echo "Date: $(date)" | tee -a "$RESULTS_FILE"
+echo "" | tee -a "$RESULTS_FILE"
+
+case "$MODE" in
+    heuristic) compare_heuristics ;;
+    branching) compare_branching ;;
+    *)
+        echo "Unknown mode: $MODE" >&2
+        exit 1
+        ;;
+esac
+
+echo "" | tee -a "$RESULTS_FILE"
+echo "Results saved to: $RESULTS_FILE"
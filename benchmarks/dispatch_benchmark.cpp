@@ -0,0 +1,152 @@
+// Benchmark: the search with its heuristic and propagation policies bound at
+// compile time (SolverFactory::createEngine on DynamicTopology) vs the
+// run-time Solver, which calls the heuristic through IHeuristic and tests
+// every optional pass
+//
+// Build from the repository root against the built library (drop -DUSE_TBB
+// and -ltbb if it was built without TBB):
+//   g++ -O3 -std=c++17 -DUSE_TBB -Iinclude -Iinclude/core -Iinclude/interfaces -Iinclude/solver
+//       benchmarks/dispatch_benchmark.cpp build/libslitherlink.a -ltbb -pthread -o dispatch_benchmark
+#include "core/Grid.h"
+#include "factory/SolverFactory.h"
+#include "solver/Solver.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace slitherlink;
+
+struct Run
+{
+    double bestMs = 1e300;
+    long long nodes = 0;
+    size_t solutions = 0;
+};
+
+template <typename MakeEngine>
+static void timeOnce(MakeEngine makeEngine, bool findAll, Run &run)
+{
+    std::unique_ptr<ISearchEngine> engine = makeEngine();
+    std::ostringstream sink;
+    std::streambuf *saved = std::cout.rdbuf(sink.rdbuf());
+    auto start = std::chrono::steady_clock::now();
+    run.solutions = engine->solve(findAll).size();
+    auto end = std::chrono::steady_clock::now();
+    std::cout.rdbuf(saved);
+    run.nodes = engine->getNodes();
+    run.bestMs = std::min(run.bestMs, std::chrono::duration<double, std::milli>(end - start).count());
+}
+
+// One search setting: a --heuristic, optionally with every optional
+// propagation pass off (the setting LocalPropagation fits)
+struct Setting
+{
+    const char *label;
+    const char *heuristic;
+    bool localOnly;
+};
+
+static SolverConfig configFor(const Setting &setting, bool findAll)
+{
+    SolverConfig config;
+    config.findAll = findAll;
+    config.enableParallel = false; // node counts are only comparable sequentially
+    config.heuristic = setting.heuristic;
+    if (setting.localOnly)
+    {
+        config.enableColoring = false;
+        config.enablePatterns = false;
+        config.bridgeInterval = 0;
+        config.parityInterval = 0;
+    }
+    return config;
+}
+
+int main(int argc, char **argv)
+{
+    // Usage: dispatch_benchmark [--all] [--rounds N] puzzle...
+    bool findAll = false;
+    int rounds = 5;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--all")
+            findAll = true;
+        else if (arg == "--rounds" && i + 1 < argc)
+            rounds = std::max(1, std::stoi(argv[++i]));
+        else
+            files.push_back(arg);
+    }
+    if (files.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [--all] [--rounds N] puzzle...\n";
+        return 2;
+    }
+
+    const Setting settings[] = {{"score", "score", false},
+                                {"score/local", "score", true},
+                                {"smart", "smart", false},
+                                {"activity", "activity", false},
+                                {"path", "path", false}};
+
+    std::cout << "=== Static vs Dynamic Dispatch Benchmark ===\n";
+    std::cout << (findAll ? "All solutions" : "First solution") << ", one thread, best of " << rounds
+              << " rounds\n\n";
+    std::cout << std::left << std::setw(28) << "Puzzle" << std::setw(13) << "Setting" << std::right
+              << std::setw(10) << "Solutions" << std::setw(11) << "Nodes" << std::setw(13) << "Dynamic ms"
+              << std::setw(12) << "Static ms" << std::setw(10) << "Speedup"
+              << "\n";
+    std::cout << std::string(97, '-') << "\n";
+
+    bool consistent = true;
+    std::vector<double> dynamicTotal(std::size(settings)), staticTotal(std::size(settings));
+    for (const std::string &file : files)
+    {
+        Grid grid;
+        if (!grid.loadFromFile(file))
+        {
+            std::cerr << "Cannot read " << file << "\n";
+            return 2;
+        }
+        for (size_t k = 0; k < std::size(settings); ++k)
+        {
+            SolverConfig config = configFor(settings[k], findAll);
+            // Rounds alternate between the two, so drift hits both alike
+            Run dynamicRun, staticRun;
+            for (int r = 0; r < rounds; ++r)
+            {
+                timeOnce([&]()
+                         { return std::make_unique<Solver>(grid, config); },
+                         findAll, dynamicRun);
+                timeOnce([&]()
+                         { return SolverFactory::createEngine(grid, config, false); },
+                         findAll, staticRun);
+            }
+            bool same = dynamicRun.nodes == staticRun.nodes && dynamicRun.solutions == staticRun.solutions;
+            consistent = consistent && same;
+            dynamicTotal[k] += dynamicRun.bestMs;
+            staticTotal[k] += staticRun.bestMs;
+
+            std::cout << std::left << std::setw(28) << file.substr(file.find_last_of('/') + 1)
+                      << std::setw(13) << settings[k].label << std::right << std::setw(10)
+                      << staticRun.solutions << std::setw(11) << staticRun.nodes << std::fixed
+                      << std::setprecision(2) << std::setw(13) << dynamicRun.bestMs << std::setw(12)
+                      << staticRun.bestMs << std::setw(9)
+                      << dynamicRun.bestMs / std::max(staticRun.bestMs, 1e-6) << "x"
+                      << (same ? "" : "  (SEARCH MISMATCH)") << "\n";
+        }
+    }
+
+    std::cout << "\nOverall speedup per setting:\n";
+    for (size_t k = 0; k < std::size(settings); ++k)
+        std::cout << "  " << std::left << std::setw(13) << settings[k].label << std::right << std::fixed
+                  << std::setprecision(2) << dynamicTotal[k] / std::max(staticTotal[k], 1e-6) << "x\n";
+    return consistent ? 0 : 1;
+}
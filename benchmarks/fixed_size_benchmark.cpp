@@ -0,0 +1,134 @@
+// Benchmark: the search over FixedTopology's constexpr adjacency tables and
+// inline state (SolverFactory::createEngine on a 5x5, 7x7 or 10x10 grid) vs
+// the same policies over DynamicTopology's run-time tables
+//
+// Build from the repository root against the built library (drop -DUSE_TBB
+// and -ltbb if it was built without TBB):
+//   g++ -O3 -std=c++17 -DUSE_TBB -Iinclude -Iinclude/core -Iinclude/interfaces -Iinclude/solver
+//       benchmarks/fixed_size_benchmark.cpp build/libslitherlink.a -ltbb -pthread -o fixed_size_benchmark
+#include "core/Grid.h"
+#include "factory/SolverFactory.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace slitherlink;
+
+struct Run
+{
+    double bestMs = 1e300;
+    long long nodes = 0;
+    size_t solutions = 0;
+};
+
+template <typename MakeEngine>
+static void timeOnce(MakeEngine makeEngine, bool findAll, Run &run)
+{
+    std::unique_ptr<ISearchEngine> engine = makeEngine();
+    std::ostringstream sink;
+    std::streambuf *saved = std::cout.rdbuf(sink.rdbuf());
+    auto start = std::chrono::steady_clock::now();
+    run.solutions = engine->solve(findAll).size();
+    auto end = std::chrono::steady_clock::now();
+    std::cout.rdbuf(saved);
+    run.nodes = engine->getNodes();
+    run.bestMs = std::min(run.bestMs, std::chrono::duration<double, std::milli>(end - start).count());
+}
+
+static SolverConfig configFor(const char *heuristic, bool findAll, bool presolve)
+{
+    SolverConfig config;
+    config.findAll = findAll;
+    config.enableParallel = false; // node counts are only comparable sequentially
+    config.enablePresolve = presolve;
+    config.heuristic = heuristic;
+    return config;
+}
+
+int main(int argc, char **argv)
+{
+    // Usage: fixed_size_benchmark [--all] [--no-presolve] [--rounds N] puzzle...
+    bool findAll = false;
+    bool presolve = true;
+    int rounds = 5;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--all")
+            findAll = true;
+        else if (arg == "--no-presolve")
+            presolve = false;
+        else if (arg == "--rounds" && i + 1 < argc)
+            rounds = std::max(1, std::stoi(argv[++i]));
+        else
+            files.push_back(arg);
+    }
+    if (files.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [--all] [--no-presolve] [--rounds N] puzzle...\n";
+        return 2;
+    }
+
+    const char *heuristics[] = {"score", "smart", "activity", "path"};
+
+    std::cout << "=== Fixed vs Dynamic Topology Benchmark ===\n";
+    std::cout << (findAll ? "All solutions" : "First solution") << (presolve ? "" : ", no presolve")
+              << ", one thread, best of " << rounds << " rounds\n\n";
+    std::cout << std::left << std::setw(28) << "Puzzle" << std::setw(13) << "Heuristic" << std::right
+              << std::setw(10) << "Solutions" << std::setw(11) << "Nodes" << std::setw(13) << "Dynamic ms"
+              << std::setw(12) << "Fixed ms" << std::setw(10) << "Speedup"
+              << "\n";
+    std::cout << std::string(97, '-') << "\n";
+
+    bool consistent = true;
+    std::vector<double> dynamicTotal(std::size(heuristics)), fixedTotal(std::size(heuristics));
+    for (const std::string &file : files)
+    {
+        Grid grid;
+        if (!grid.loadFromFile(file))
+        {
+            std::cerr << "Cannot read " << file << "\n";
+            return 2;
+        }
+        for (size_t k = 0; k < std::size(heuristics); ++k)
+        {
+            SolverConfig config = configFor(heuristics[k], findAll, presolve);
+            // Rounds alternate between the two, so drift hits both alike
+            Run dynamicRun, fixedRun;
+            for (int r = 0; r < rounds; ++r)
+            {
+                timeOnce([&]()
+                         { return SolverFactory::createEngine(grid, config, false); },
+                         findAll, dynamicRun);
+                timeOnce([&]()
+                         { return SolverFactory::createEngine(grid, config); },
+                         findAll, fixedRun);
+            }
+            bool same = dynamicRun.nodes == fixedRun.nodes && dynamicRun.solutions == fixedRun.solutions;
+            consistent = consistent && same;
+            dynamicTotal[k] += dynamicRun.bestMs;
+            fixedTotal[k] += fixedRun.bestMs;
+
+            std::cout << std::left << std::setw(28) << file.substr(file.find_last_of('/') + 1)
+                      << std::setw(13) << heuristics[k] << std::right << std::setw(10)
+                      << fixedRun.solutions << std::setw(11) << fixedRun.nodes << std::fixed
+                      << std::setprecision(2) << std::setw(13) << dynamicRun.bestMs << std::setw(12)
+                      << fixedRun.bestMs << std::setw(9)
+                      << dynamicRun.bestMs / std::max(fixedRun.bestMs, 1e-6) << "x"
+                      << (same ? "" : "  (SEARCH MISMATCH)") << "\n";
+        }
+    }
+
+    std::cout << "\nOverall speedup per heuristic:\n";
+    for (size_t k = 0; k < std::size(heuristics); ++k)
+        std::cout << "  " << std::left << std::setw(13) << heuristics[k] << std::right << std::fixed
+                  << std::setprecision(2) << dynamicTotal[k] / std::max(fixedTotal[k], 1e-6) << "x\n";
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+// Microbenchmark: counter-and-branch cell/point rules vs LocalRuleTable lookups
+//
+// Build from the repository root:
+//   g++ -O3 -std=c++17 -Iinclude -Iinclude/core benchmarks/propagation_kernel_benchmark.cpp
+//       src/core/State.cpp -o propagation_kernel_benchmark
+#include "core/State.h"
+#include "solver/LocalRuleTable.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace slitherlink;
+
+struct Board
+{
+    int n, m;
+    std::vector<int> clues;
+    std::vector<std::vector<int>> cellEdges;
+    std::vector<std::vector<int>> pointEdges;
+    std::vector<std::pair<int, int>> edgeCells;  ///< Cells on both sides, -1 outside
+    std::vector<std::pair<int, int>> edgePoints; ///< End points
+};
+
+// Same edge numbering as Solver::buildEdges: horizontal rows, then vertical
+static Board makeBoard(int n, int m, std::mt19937 &rng)
+{
+    Board b{n, m, std::vector<int>(n * m), std::vector<std::vector<int>>(n * m),
+            std::vector<std::vector<int>>((n + 1) * (m + 1)), {}, {}};
+    std::uniform_int_distribution<int> clue(-1, 3);
+    for (int &c : b.clues)
+        c = clue(rng);
+
+    auto add = [&](int p, int q, int cellA, int cellB)
+    {
+        int idx = (int)b.edgeCells.size();
+        b.edgeCells.push_back({cellA, cellB});
+        b.edgePoints.push_back({p, q});
+        b.pointEdges[p].push_back(idx);
+        b.pointEdges[q].push_back(idx);
+        if (cellA >= 0)
+            b.cellEdges[cellA].push_back(idx);
+        if (cellB >= 0)
+            b.cellEdges[cellB].push_back(idx);
+    };
+    for (int r = 0; r <= n; ++r)
+        for (int c = 0; c < m; ++c)
+            add(r * (m + 1) + c, r * (m + 1) + c + 1, r > 0 ? (r - 1) * m + c : -1, r < n ? r * m + c : -1);
+    for (int r = 0; r < n; ++r)
+        for (int c = 0; c <= m; ++c)
+            add(r * (m + 1) + c, (r + 1) * (m + 1) + c, c > 0 ? r * m + c - 1 : -1, c < m ? r * m + c : -1);
+    return b;
+}
+
+// Random partial assignment with the counters the branchy rules read
+static State randomState(const Board &b, std::mt19937 &rng)
+{
+    State s;
+    s.initialize(b.edgeCells.size(), b.pointEdges.size(), b.cellEdges.size());
+    for (size_t i = 0; i < b.cellEdges.size(); ++i)
+        s.setCellUndecided((int)i, 4);
+    for (size_t i = 0; i < b.pointEdges.size(); ++i)
+        s.setPointUndecided((int)i, (int)b.pointEdges[i].size());
+
+    std::uniform_int_distribution<int> pick(0, 5);
+    for (size_t e = 0; e < b.edgeCells.size(); ++e)
+    {
+        int v = pick(rng);
+        char val = (v < 2) ? 0 : (v < 4) ? -1 : 1;
+        if (val == 0)
+            continue;
+        s.setEdgeState((int)e, val);
+        for (int cell : {b.edgeCells[e].first, b.edgeCells[e].second})
+        {
+            if (cell < 0)
+                continue;
+            s.decrementCellUndecided(cell);
+            if (val == 1)
+                s.incrementCellEdgeCount(cell);
+        }
+        for (int p : {b.edgePoints[e].first, b.edgePoints[e].second})
+        {
+            s.decrementPointUndecided(p);
+            if (val == 1)
+                s.incrementPointDegree(p);
+        }
+    }
+    return s;
+}
+
+// The rules as Solver::propagateConstraints wrote them before the tables
+// (counters, comparisons, and a scan for the undecided edges to force),
+// plus the dead-end point rule the tables added, so both compute the same
+static long long branchyKernel(const Board &b, const State &s)
+{
+    long long sum = 0;
+    for (size_t cell = 0; cell < b.cellEdges.size(); ++cell)
+    {
+        int clue = b.clues[cell];
+        if (clue < 0)
+            continue;
+        int on = s.getCellEdgeCount((int)cell), und = s.getCellUndecided((int)cell);
+        if (on > clue || on + und < clue)
+        {
+            sum += 1000003;
+            continue;
+        }
+        if (und == 0)
+            continue;
+        if (on + und == clue)
+        {
+            for (int e : b.cellEdges[cell])
+                if (s.getEdgeState(e) == 0)
+                    sum += e;
+        }
+        else if (on == clue)
+        {
+            for (int e : b.cellEdges[cell])
+                if (s.getEdgeState(e) == 0)
+                    sum -= e;
+        }
+    }
+    for (size_t p = 0; p < b.pointEdges.size(); ++p)
+    {
+        int deg = s.getPointDegree((int)p), und = s.getPointUndecided((int)p);
+        if (deg > 2 || (deg == 1 && und == 0))
+        {
+            sum += 1000003;
+            continue;
+        }
+        if ((deg == 1 && und == 1) || deg == 2 || (deg == 0 && und == 1))
+        {
+            for (int e : b.pointEdges[p])
+                if (s.getEdgeState(e) == 0)
+                    sum += (deg == 1) ? e : -e;
+        }
+    }
+    return sum;
+}
+
+static long long tableKernel(const Board &b, const State &s)
+{
+    long long sum = 0;
+    auto code = [&s](int e)
+    { return s.getEdgeCode(e); };
+    auto apply = [&sum](const int *list, unsigned rule)
+    {
+        if (rule == LocalRules::CONFLICT)
+        {
+            sum += 1000003;
+            return;
+        }
+        for (; rule; rule &= rule - 1)
+        {
+            int bit = __builtin_ctz(rule);
+            sum += (bit < 4) ? list[bit] : -list[bit & 3];
+        }
+    };
+    for (size_t cell = 0; cell < b.cellEdges.size(); ++cell)
+    {
+        int clue = b.clues[cell];
+        if (clue < 0)
+            continue;
+        const int *list = b.cellEdges[cell].data();
+        apply(list, LocalRules::cellRule(clue, LocalRules::key(list, 4, code)));
+    }
+    for (size_t p = 0; p < b.pointEdges.size(); ++p)
+    {
+        const std::vector<int> &list = b.pointEdges[p];
+        apply(list.data(), LocalRules::pointTable[LocalRules::key(list.data(), (int)list.size(), code)]);
+    }
+    return sum;
+}
+
+template <typename Kernel>
+static double timeKernel(const Board &b, const std::vector<State> &states, int rounds, Kernel kernel,
+                         long long &checksum)
+{
+    checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (const State &s : states)
+            checksum += kernel(b, s);
+    auto end = std::chrono::steady_clock::now();
+    double visits = (double)rounds * states.size() * (b.cellEdges.size() + b.pointEdges.size());
+    return std::chrono::duration<double, std::nano>(end - start).count() / visits;
+}
+
+int main(int argc, char **argv)
+{
+    int size = argc >= 2 ? std::stoi(argv[1]) : 20;
+    int rounds = argc >= 3 ? std::stoi(argv[2]) : 2000;
+
+    std::mt19937 rng(12345);
+    Board board = makeBoard(size, size, rng);
+    std::vector<State> states;
+    for (int i = 0; i < 64; ++i)
+        states.push_back(randomState(board, rng));
+
+    std::cout << "=== Propagation Kernel Benchmark ===\n";
+    std::cout << size << "x" << size << " grid, " << states.size() << " random states, " << rounds
+              << " rounds\n\n";
+
+    long long branchySum = 0, tableSum = 0;
+    double branchy = timeKernel(board, states, rounds, branchyKernel, branchySum);
+    double table = timeKernel(board, states, rounds, tableKernel, tableSum);
+
+    std::cout << std::setw(12) << "Kernel" << std::setw(16) << "ns / visit" << std::setw(20) << "Checksum" << "\n";
+    std::cout << std::string(48, '-') << "\n";
+    std::cout << std::setw(12) << "branchy" << std::setw(16) << std::fixed << std::setprecision(3) << branchy
+              << std::setw(20) << branchySum << "\n";
+    std::cout << std::setw(12) << "table" << std::setw(16) << table << std::setw(20) << tableSum << "\n";
+    std::cout << "\nSpeedup: " << std::setprecision(2) << branchy / table << "x"
+              << (branchySum == tableSum ? "" : "  (CHECKSUM MISMATCH)") << "\n";
+    return branchySum == tableSum ? 0 : 1;
+}
@@ -16,7 +16,8 @@ namespace slitherlink
         int cellA; ///< First adjacent cell (-1 if none)
         int cellB; ///< Second adjacent cell (-1 if none)
 
-        Edge(int u, int v, int cellA, int cellB)
+        constexpr Edge() : u(0), v(0), cellA(-1), cellB(-1) {}
+        constexpr Edge(int u, int v, int cellA, int cellB)
             : u(u), v(v), cellA(cellA), cellB(cellB) {}
     };
 
@@ -21,6 +21,11 @@ namespace slitherlink
         int getRows() const { return n; }
         int getCols() const { return m; }
         int getClue(int row, int col) const;
+
+        /**
+         * @brief Set a cell's clue; cells outside the grid are ignored
+         * @throws std::invalid_argument if value is not -1 (no clue) or 0-3
+         */
         void setClue(int row, int col, int value);
 
         int cellIndex(int r, int c) const { return r * m + c; }
@@ -1,6 +1,9 @@
 #ifndef SLITHERLINK_STATE_H
 #define SLITHERLINK_STATE_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace slitherlink
@@ -10,53 +13,394 @@ namespace slitherlink
      * @brief Represents the current state of the search
      *
      * Single Responsibility: State management and data storage
-     * Cache-friendly layout with frequently accessed data grouped together
+     * Packed layout: edge states at 2 bits each, segment mates and color
+     * union-find links as 16-bit indices and all counters as bytes, held in
+     * one cache-line-aligned block so a copy is a single memcpy (under 10 KB
+     * for a 20x20 grid, edge selection classes included). Blocks of grids up
+     * to 10x10, every fixed-size topology among them, live inline in the
+     * State itself; larger ones are allocated.
      */
     class State
     {
     public:
+        static constexpr size_t CACHE_LINE = 64;
+
+        /** @brief Size of the packed block for the given counts, in whole cache lines */
+        static constexpr size_t blockBytes(size_t edgeCount, size_t pointCount, size_t cellCount)
+        {
+            size_t classWords = (edgeCount + 63) / 64;
+            size_t mapWords = (classWords + 63) / 64;
+            size_t edgeBytes = ((edgeCount + 31) / 32) * sizeof(uint64_t);
+            size_t classBytes = SCORE_CLASSES * (mapWords * sizeof(uint64_t) + sizeof(uint32_t) + classWords);
+            size_t bytes = edgeBytes + classBytes + edgeCount + 6 * pointCount + 4 * cellCount + 7 * (cellCount + 1);
+            return (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+        }
+
+        /** @brief Largest block kept inline: a 10x10 grid's */
+        static constexpr size_t INLINE_BYTES = 3136;
+
         State() = default;
-        State(const State &) = default;
-        State(State &&) noexcept = default;
-        State &operator=(const State &) = default;
-        State &operator=(State &&) noexcept = default;
+        State(const State &other);
+        State(State &&other) noexcept;
+        State &operator=(const State &other);
+        State &operator=(State &&other) noexcept;
+        ~State();
+
+        // Accessors (edge codes: 00=undecided, 01=ON, 10=OFF)
+        char getEdgeState(int idx) const
+        {
+            static constexpr char decode[4] = {0, 1, -1, 0};
+            return decode[getEdgeCode(idx)];
+        }
+        int getEdgeCode(int idx) const { return (edgeBits[idx >> 5] >> ((idx & 31) << 1)) & 3; }
+        void setEdgeState(int idx, char val)
+        {
+            uint64_t &word = edgeBits[idx >> 5];
+            int shift = (idx & 31) << 1;
+            uint64_t code = (val == 1) ? 1 : (val == -1) ? 2 : 0;
+            word = (word & ~(uint64_t(3) << shift)) | (code << shift);
+        }
+
+        // Point counters are interleaved (degree, undecided) so one point
+        // touches one byte pair; cells likewise (ON count, undecided)
+        int getPointDegree(int idx) const { return pointCounters[2 * idx]; }
+        void setPointDegree(int idx, int val) { pointCounters[2 * idx] = (uint8_t)val; }
+        void incrementPointDegree(int idx) { pointCounters[2 * idx]++; }
+        void decrementPointDegree(int idx) { pointCounters[2 * idx]--; }
+
+        // Every decision and undo changes the undecided counts of the edge's
+        // points and cells, so those mark them stale for edge selection
+        int getPointUndecided(int idx) const { return pointCounters[2 * idx + 1]; }
+        void setPointUndecided(int idx, int val) { pointCounters[2 * idx + 1] = (uint8_t)val; }
+        void incrementPointUndecided(int idx)
+        {
+            pointCounters[2 * idx + 1]++;
+            markPointStale(idx);
+        }
+        void decrementPointUndecided(int idx)
+        {
+            pointCounters[2 * idx + 1]--;
+            markPointStale(idx);
+        }
+
+        int getCellEdgeCount(int idx) const { return cellCounters[2 * idx]; }
+        void setCellEdgeCount(int idx, int val) { cellCounters[2 * idx] = (uint8_t)val; }
+        void incrementCellEdgeCount(int idx) { cellCounters[2 * idx]++; }
+        void decrementCellEdgeCount(int idx) { cellCounters[2 * idx]--; }
+
+        int getCellUndecided(int idx) const { return cellCounters[2 * idx + 1]; }
+        void setCellUndecided(int idx, int val) { cellCounters[2 * idx + 1] = (uint8_t)val; }
+        void incrementCellUndecided(int idx)
+        {
+            cellCounters[2 * idx + 1]++;
+            markCellStale(idx);
+        }
+        void decrementCellUndecided(int idx)
+        {
+            cellCounters[2 * idx + 1]--;
+            markCellStale(idx);
+        }
+
+        // Path segments formed by ON edges: a degree-1 point stores the other
+        // end of its segment (mate); other points' entries are stale
+        int getMate(int idx) const { return pointMate[idx]; }
+        int getOpenSegments() const { return openSegments; }
+        int getClosedLoops() const { return closedLoops; }
+
+        // Clue cells whose ON count differs from the clue, kept by the
+        // solver as it changes cell counts, so closing the loop is checked
+        // without scanning the clues
+        int getUnsatisfiedClues() const { return unsatisfiedClues; }
+        void setUnsatisfiedClues(int count) { unsatisfiedClues = count; }
+        void adjustUnsatisfiedClues(int delta) { unsatisfiedClues += delta; }
+
+        /**
+         * @brief Join the segments at u and v for a new ON edge (u, v)
+         *
+         * Call before the degrees of u and v are incremented. Marks the
+         * two ends of the resulting segment dirty; closing a segment into
+         * a loop is counted in getClosedLoops(). Logged for unlinkSegment.
+         */
+        void linkSegment(int u, int v);
+        /** @brief Undo the most recent linkSegment */
+        void unlinkSegment();
+
+        // Reachability certificate: the state at trail size getReachMark()
+        // had all ON edges in one component of the ON/undecided graph, and
+        // so does every prefix of it. Segments started since then are
+        // counted by getSegmentsStarted() - getReachSegments()
+        size_t getReachMark() const { return reachMark; }
+        int getReachSegments() const { return reachSegments; }
+        int getSegmentsStarted() const { return segmentsStarted; }
+        void setReachMark()
+        {
+            reachMark = trail.size();
+            reachSegments = segmentsStarted;
+        }
+
+        // Cell colors (inside/outside the loop) as a union-find with parity
+        // over the cells plus the outside region (index getOutsideCell()).
+        // Sets are merged by size without path compression, so a merge is
+        // undone in O(1); each set's members form a circular list
+        int getOutsideCell() const { return (int)cellCount; }
+        int findColor(int cell, int &parity) const
+        {
+            parity = 0;
+            while (colorParent[cell] != cell)
+            {
+                parity ^= colorParity[cell];
+                cell = colorParent[cell];
+            }
+            return cell;
+        }
+        int getColorSetSize(int root) const { return colorSize[root]; }
+        int getColorNext(int cell) const { return colorNext[cell]; }
+
+        /**
+         * @brief Merge two color sets
+         * @param rootA Root of the first set
+         * @param rootB Root of the second set (different from rootA)
+         * @param parity 1 if the roots have different colors
+         *
+         * Logged against the current trail size; undoColors(mark) reverts
+         * every merge made once the trail was longer than mark.
+         */
+        void mergeColors(int rootA, int rootB, int parity);
+        void undoColors(size_t trailMark);
+        /** @brief Color merges logged so far; undoColorMerges(n) keeps the first n */
+        size_t getColorLogSize() const { return colorLog.size(); }
+        void undoColorMerges(size_t logSize);
 
-        // Accessors
-        char getEdgeState(int idx) const { return edgeState[idx]; }
-        void setEdgeState(int idx, char val) { edgeState[idx] = val; }
+        // Bridge pass position: only components touched by OFF edges at or
+        // after getBridgeMark() can have gained a bridge since the last pass
+        size_t getBridgeMark() const { return bridgeMark; }
+        void setBridgeMark(size_t mark) { bridgeMark = mark; }
 
-        int getPointDegree(int idx) const { return pointDegree[idx]; }
-        void setPointDegree(int idx, int val) { pointDegree[idx] = val; }
-        void incrementPointDegree(int idx) { pointDegree[idx]++; }
+        // Trail size at the last parity elimination pass
+        size_t getParityMark() const { return parityMark; }
+        void setParityMark(size_t mark) { parityMark = mark; }
 
-        int getPointUndecided(int idx) const { return pointUndecided[idx]; }
-        void setPointUndecided(int idx, int val) { pointUndecided[idx] = val; }
-        void decrementPointUndecided(int idx) { pointUndecided[idx]--; }
+        // Trail entries below getPatternMark() were matched against the
+        // pattern library
+        size_t getPatternMark() const { return patternMark; }
+        void setPatternMark(size_t mark) { patternMark = mark; }
 
-        int getCellEdgeCount(int idx) const { return cellEdgeCount[idx]; }
-        void setCellEdgeCount(int idx, int val) { cellEdgeCount[idx] = val; }
-        void incrementCellEdgeCount(int idx) { cellEdgeCount[idx]++; }
+        // Trail size at the last implication graph pass
+        size_t getImplicationMark() const { return implicationMark; }
+        void setImplicationMark(size_t mark) { implicationMark = mark; }
 
-        int getCellUndecided(int idx) const { return cellUndecided[idx]; }
-        void setCellUndecided(int idx, int val) { cellUndecided[idx] = val; }
-        void decrementCellUndecided(int idx) { cellUndecided[idx]--; }
+        // Trail entries below getWindowMark() had their windows filtered
+        size_t getWindowMark() const { return windowMark; }
+        void setWindowMark(size_t mark) { windowMark = mark; }
 
-        // Direct access for performance-critical code
-        std::vector<char> &getEdgeStateVector() { return edgeState; }
-        const std::vector<char> &getEdgeStateVector() const { return edgeState; }
+        // Trail (undo log): every decided edge in assignment order, so the
+        // search can backtrack by popping instead of copying the whole state
+        void pushTrail(int edgeIdx) { trail.push_back(edgeIdx); }
+        int popTrail()
+        {
+            int edgeIdx = trail.back();
+            trail.pop_back();
+            return edgeIdx;
+        }
+        size_t getTrailSize() const { return trail.size(); }
+        int getTrailAt(size_t pos) const { return trail[pos]; }
+        /**
+         * @brief Id of the assignment the trail starts from
+         *
+         * Fresh from initialize() and clearTrail(), kept by copies, so two
+         * states with the same id decided the same edges off the trail.
+         */
+        uint64_t getTrailOrigin() const { return trailOrigin; }
+        void clearTrail()
+        {
+            trail.clear();
+            trailOrigin = nextTrailOrigin();
+            segmentLog.clear();
+            colorLog.clear(); // merges so far become permanent
+            reachSegments = -1; // no certificate for the new trail origin
+            bridgeMark = 0;
+            parityMark = 0;
+            patternMark = 0;
+            windowMark = 0;
+            implicationMark = 0;
+        }
 
-        // Initialization
+        // Dirty sets: points and cells touched since the last propagation
+        // fixpoint, so propagation drains them instead of rescanning the grid
+        void markPointDirty(int idx)
+        {
+            if (!pointDirty[idx])
+            {
+                pointDirty[idx] = 1;
+                dirtyPoints.push_back(idx);
+            }
+        }
+        void markCellDirty(int idx)
+        {
+            if (!cellDirty[idx])
+            {
+                cellDirty[idx] = 1;
+                dirtyCells.push_back(idx);
+            }
+        }
+        bool hasDirtyPoints() const { return !dirtyPoints.empty(); }
+        bool hasDirtyCells() const { return !dirtyCells.empty(); }
+        int takeDirtyPoint()
+        {
+            int idx = dirtyPoints.back();
+            dirtyPoints.pop_back();
+            pointDirty[idx] = 0;
+            return idx;
+        }
+        int takeDirtyCell()
+        {
+            int idx = dirtyCells.back();
+            dirtyCells.pop_back();
+            cellDirty[idx] = 0;
+            return idx;
+        }
+        void clearDirty();
+
+        // Edge selection classes: the solver files each undecided edge under
+        // its score class (0 is the best of SCORE_CLASSES), kept per class
+        // as a count per 64-edge word plus a bitmap of the words holding
+        // one, so the first edge of a class at or after a scan position is
+        // found without scoring the grid. Points and cells whose undecided
+        // count changed are stale; the solver refiles their edges before
+        // choosing. A fresh state is all stale with nothing filed
+        static constexpr int SCORE_CLASSES = 64;
+        int getEdgeClass(int idx) const { return edgeClass[idx] == NO_CLASS ? -1 : edgeClass[idx]; }
+        /** @brief Move an edge to class cls; -1 takes it out */
+        void fileEdge(int idx, int cls);
+        int getBestClass() const { return classMask ? __builtin_ctzll(classMask) : -1; }
+        /** @brief First edge of class cls at or after from, wrapping around; -1 if none */
+        int firstInClass(int cls, int from) const;
+        bool hasStalePoints() const { return !stalePoints.empty(); }
+        bool hasStaleCells() const { return !staleCells.empty(); }
+        int takeStalePoint()
+        {
+            int idx = stalePoints.back();
+            stalePoints.pop_back();
+            pointStale[idx] = 0;
+            return idx;
+        }
+        int takeStaleCell()
+        {
+            int idx = staleCells.back();
+            staleCells.pop_back();
+            cellStale[idx] = 0;
+            return idx;
+        }
+
+        // Zobrist hash of the edge assignment; the solver XORs one key per
+        // (edge, value) in when deciding and out again when undoing
+        uint64_t getHash() const { return hash; }
+        void toggleHash(uint64_t key) { hash ^= key; }
+
+        size_t getEdgeCount() const { return edgeCount; }
+        size_t getBlockSize() const { return blockSize; }
+
+        // Unpacked copy of all edge states (0/1/-1), e.g. for a Solution
+        std::vector<char> getEdgeStates() const;
+
+        // Initialization: all edges undecided, all counters zero, and every
+        // point and cell dirty so the first propagation sees the whole grid.
+        // Throws std::length_error if a count does not fit the 16-bit indices
+        // (over 32767 points, about a 180x180 grid)
         void initialize(size_t edgeCount, size_t pointCount, size_t cellCount);
 
     private:
-        // Cache-friendly layout: group frequently accessed data together
-        std::vector<char> edgeState;     ///< 0=undecided, 1=ON, -1=OFF
-        std::vector<int> pointDegree;    ///< Number of ON edges at each point
-        std::vector<int> pointUndecided; ///< Number of undecided edges per point
-        std::vector<int> cellEdgeCount;  ///< Number of ON edges around each cell
-        std::vector<int> cellUndecided;  ///< Number of undecided edges per cell
+        struct SegmentUndo
+        {
+            int16_t a, oldMateA; ///< Far end of u's side and its previous mate
+            int16_t b, oldMateB; ///< Far end of v's side and its previous mate
+            int8_t segmentDelta;
+            int8_t closedLoop;
+        };
+
+        struct ColorUndo
+        {
+            int16_t child;   ///< Root attached below parent
+            int16_t parent;
+            uint32_t stamp;  ///< Trail size when merged
+        };
+
+        static constexpr uint8_t NO_CLASS = 0xFF;
+
+        static uint64_t nextTrailOrigin();
+        void markPointStale(int idx)
+        {
+            if (!pointStale[idx])
+            {
+                pointStale[idx] = 1;
+                stalePoints.push_back(idx);
+            }
+        }
+        void markCellStale(int idx)
+        {
+            if (!cellStale[idx])
+            {
+                cellStale[idx] = 1;
+                staleCells.push_back(idx);
+            }
+        }
+        void allocate(size_t bytes);
+        void release();
+        void bindLayout();
+        void popColorMerge();
+
+        uint8_t *block = nullptr; ///< inlineBlock or one aligned allocation, backing everything below
+        size_t blockSize = 0;
+        size_t edgeCount = 0;
+        size_t pointCount = 0;
+        size_t cellCount = 0;
+        uint64_t hash = 0;
+        uint64_t trailOrigin = 0;
+        int openSegments = 0;
+        int closedLoops = 0;
+        int unsatisfiedClues = 0;
+        int segmentsStarted = 0;
+        size_t reachMark = 0;
+        int reachSegments = 0;
+        size_t bridgeMark = 0;
+        size_t parityMark = 0;
+        size_t patternMark = 0;
+        size_t windowMark = 0;
+        size_t implicationMark = 0;
+        size_t classWordCount = 0;        ///< 64-edge words per class
+        size_t classMapWords = 0;         ///< Bitmap words per class
+        uint64_t classMask = 0;           ///< Bit c set if class c holds an edge
+
+        uint64_t *edgeBits = nullptr;     ///< 32 edges per word, 2 bits each
+        uint64_t *classMaps = nullptr;    ///< Per class: bitmap of its non-empty words
+        uint32_t *classSizes = nullptr;   ///< Per class: edges filed
+        int16_t *pointMate = nullptr;     ///< Per point: other end of its segment
+        int16_t *colorParent = nullptr;   ///< Per cell (+ outside): union-find parent
+        int16_t *colorNext = nullptr;     ///< Per cell: next member of its set
+        int16_t *colorSize = nullptr;     ///< Per root: set size
+        uint8_t *pointCounters = nullptr; ///< Per point: ON degree, undecided edges
+        uint8_t *cellCounters = nullptr;  ///< Per cell: ON edges, undecided edges
+        uint8_t *colorParity = nullptr;   ///< Per cell: 1 if colored unlike its parent
+        uint8_t *pointDirty = nullptr;    ///< 1 if the point is in dirtyPoints
+        uint8_t *cellDirty = nullptr;     ///< 1 if the cell is in dirtyCells
+        uint8_t *edgeClass = nullptr;     ///< Per edge: its class, NO_CLASS if not filed
+        uint8_t *classCounts = nullptr;   ///< Per class and 64-edge word: edges filed
+        uint8_t *pointStale = nullptr;    ///< 1 if the point is in stalePoints
+        uint8_t *cellStale = nullptr;     ///< 1 if the cell is in staleCells
+
+        std::vector<int> trail; ///< Decided edge indices, oldest first
+        std::vector<SegmentUndo> segmentLog; ///< One entry per ON edge on the trail
+        std::vector<ColorUndo> colorLog;      ///< Color merges, oldest first
+        std::vector<int> dirtyPoints;
+        std::vector<int> dirtyCells;
+        std::vector<int> stalePoints;
+        std::vector<int> staleCells;
+
+        alignas(CACHE_LINE) std::array<uint8_t, INLINE_BYTES> inlineBlock;
     };
 
+    static_assert(State::blockBytes(220, 121, 100) == State::INLINE_BYTES, "INLINE_BYTES holds a 10x10 grid");
+
 } // namespace slitherlink
 
 #endif // SLITHERLINK_STATE_H
@@ -2,7 +2,7 @@
 #define SLITHERLINK_FACTORY_SLITHERLINKSOLVER_H
 
 #include "core/Grid.h"
-#include "solver/Solver.h"
+#include "interfaces/ISearchEngine.h"
 #include <memory>
 #include <iostream>
 
@@ -16,21 +16,24 @@ namespace slitherlink
     /**
      * @brief Main solver facade (SOLID architecture version - not currently used)
      *
-     * This is part of the planned SOLID refactoring but not yet integrated.
-     * The current system uses the monolithic main.cpp.
+     * Runs the search engine SolverFactory picked and hands its solutions
+     * to the collector and printer. The current system uses the
+     * monolithic main.cpp.
      */
     class SlitherlinkSolver
     {
     private:
         Grid grid;
+        std::unique_ptr<ISearchEngine> engine;
+        bool findAll;
         std::shared_ptr<ISolutionCollector> solutionCollector;
         std::shared_ptr<ISolutionPrinter> solutionPrinter;
-        // TODO: Add Solver when SOLID refactoring is complete
-        // std::unique_ptr<Solver> solver;
 
     public:
         SlitherlinkSolver(
             const Grid &g,
+            std::unique_ptr<ISearchEngine> e,
+            bool findAllSolutions,
             std::shared_ptr<ISolutionCollector> sc,
             std::shared_ptr<ISolutionPrinter> sp);
 
@@ -3,6 +3,8 @@
 
 #include "core/Grid.h"
 #include "factory/SlitherlinkSolver.h"
+#include "interfaces/ISearchEngine.h"
+#include "utils/Config.h"
 #include <memory>
 
 namespace slitherlink
@@ -11,12 +13,27 @@ namespace slitherlink
     /**
      * @brief Factory for creating SlitherlinkSolver instances (SOLID architecture)
      *
-     * Part of planned SOLID refactoring - not currently used in production.
+     * The CLI runs the engine createEngine picks; createSolver wraps the
+     * same engine in the SOLID SlitherlinkSolver.
      */
     class SolverFactory
     {
     public:
         static std::unique_ptr<SlitherlinkSolver> createSolver(const Grid &grid, bool findAll = false);
+
+        /**
+         * @brief The Solver search for a grid, behind ISearchEngine
+         *
+         * The engine is the BasicSolver instantiation whose heuristic and
+         * propagation policies match config, so the search itself makes no
+         * virtual calls; Solver is the same search dispatching at run time.
+         * @param fixedSize Use the instantiation with compile-time dimensions
+         * and inline state for a 5x5, 7x7 or 10x10 grid; other sizes, or
+         * false, get DynamicTopology
+         */
+        static std::unique_ptr<ISearchEngine> createEngine(const Grid &grid,
+                                                           const SolverConfig &config = SolverConfig(),
+                                                           bool fixedSize = true);
     };
 
 } // namespace slitherlink
@@ -2,6 +2,7 @@
 #define SLITHERLINK_IHEURISTIC_H
 
 #include "State.h"
+#include <cstddef>
 
 namespace slitherlink
 {
@@ -23,6 +24,18 @@ namespace slitherlink
          * @return Index of selected edge, or size() if no edges left
          */
         virtual int selectNextEdge(const State &state) const = 0;
+
+        /**
+         * @brief Note a contradiction found by propagation
+         * @param state State at the conflict
+         * @param trailMark Trail size before the last decision; the edges
+         *        from here on were assigned by it
+         */
+        virtual void onConflict(const State &state, size_t trailMark)
+        {
+            (void)state;
+            (void)trailMark;
+        }
     };
 
 } // namespace slitherlink
@@ -32,6 +32,13 @@ namespace slitherlink
          * @return true if decision is valid, false otherwise
          */
         virtual bool applyDecision(State &state, int edgeIdx, int value) const = 0;
+
+        /**
+         * @brief Roll back decisions recorded on the state's trail
+         * @param state State to restore (modified in place)
+         * @param trailMark Trail size to roll back to (from State::getTrailSize)
+         */
+        virtual void undoDecisions(State &state, size_t trailMark) const = 0;
     };
 
 } // namespace slitherlink
@@ -0,0 +1,42 @@
+#ifndef SLITHERLINK_ISEARCHENGINE_H
+#define SLITHERLINK_ISEARCHENGINE_H
+
+#include "Solution.h"
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief A search engine as SlitherlinkSolver runs it
+     *
+     * One virtual call per solve: every BasicSolver instantiation implements
+     * it over its own search, and SolverFactory hands out the one matching
+     * the configuration.
+     */
+    class ISearchEngine
+    {
+    public:
+        virtual ~ISearchEngine() = default;
+
+        /**
+         * @brief Depth-first search from the empty grid
+         * @param findAll Keep searching after the first solution
+         * @return Solutions found, in search order
+         */
+        virtual std::vector<Solution> solve(bool findAll) = 0;
+
+        /**
+         * @brief Search nodes visited by the last solve
+         */
+        virtual long long getNodes() const = 0;
+
+        /**
+         * @brief Print the summary of the last solve
+         */
+        virtual void printSolutions() const = 0;
+    };
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_ISEARCHENGINE_H
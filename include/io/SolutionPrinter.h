@@ -5,7 +5,6 @@
 #include "core/Solution.h"
 #include <iostream>
 #include <vector>
-#include <map>
 
 namespace slitherlink
 {
@@ -30,14 +29,14 @@ namespace slitherlink
     {
     private:
         Grid grid;
-        std::map<std::pair<int, int>, int> horizEdgeIndex;
-        std::map<std::pair<int, int>, int> vertEdgeIndex;
+        std::vector<int> horizEdgeIndex;
+        std::vector<int> vertEdgeIndex;
 
     public:
         SolutionPrinter(
             const Grid &g,
-            const std::map<std::pair<int, int>, int> &hIndex,
-            const std::map<std::pair<int, int>, int> &vIndex);
+            const std::vector<int> &hIndex,
+            const std::vector<int> &vIndex);
 
         void printSolution(const Solution &sol, std::ostream &out = std::cout) const override;
         void printSummary(size_t count, std::ostream &out = std::cout) const override;
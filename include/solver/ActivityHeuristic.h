@@ -0,0 +1,50 @@
+#ifndef SLITHERLINK_ACTIVITY_HEURISTIC_H
+#define SLITHERLINK_ACTIVITY_HEURISTIC_H
+
+#include "IHeuristic.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Conflict-activity (VSIDS-style) edge selection
+     *
+     * Every contradiction bumps the activity of the edges assigned since
+     * the last decision, the decision included. Older bumps fade: each
+     * conflict grows the bump by 1 / decay, and all activities are scaled
+     * down together when they get too large. The undecided edge with the
+     * highest activity is chosen, ties going to the higher local score
+     * (so before the first conflict this is plain score order).
+     *
+     * Thread-safe: conflicts are serialized, selection reads relaxed.
+     */
+    class ActivityHeuristic final : public IHeuristic
+    {
+    public:
+        /** @brief Local score of an undecided edge; higher is chosen first */
+        using LocalScore = std::function<int(const State &, int)>;
+
+        ActivityHeuristic(size_t edgeCount, double decay, LocalScore localScore);
+
+        int selectNextEdge(const State &state) const override;
+        void onConflict(const State &state, size_t trailMark) override;
+
+        long long getConflicts() const { return conflicts.load(std::memory_order_relaxed); }
+        double getActivity(int edgeIdx) const { return activity[edgeIdx].load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<std::atomic<double>> activity;
+        double bump = 1.0;
+        double decay;
+        LocalScore localScore;
+        std::mutex bumpMutex;
+        std::atomic<long long> conflicts{0};
+    };
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_ACTIVITY_HEURISTIC_H
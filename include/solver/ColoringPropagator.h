@@ -0,0 +1,178 @@
+#ifndef SLITHERLINK_COLORING_PROPAGATOR_H
+#define SLITHERLINK_COLORING_PROPAGATOR_H
+
+#include "Edge.h"
+#include "State.h"
+#include <utility>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Inside/outside cell coloring rules
+     *
+     * Every cell is inside or outside the loop, the region beyond the border
+     * counting as one more (outside) cell, and an edge is ON exactly when
+     * its two cells differ. Decided edges merge cells into the State's color
+     * union-find with parity. From the colors it derives:
+     * - an undecided edge between two cells of one set is fixed by their
+     *   parity, and a decided edge that disagrees is a contradiction;
+     * - a clue cell's undecided neighbours fall into a few sets, and the
+     *   cell's unknown relation to each set decides all of that set's edges
+     *   at once; a relation shared by every way of meeting the clue is
+     *   forced, and no way at all is a contradiction.
+     *
+     * The solver's propagation loop calls mergeEdge() for each decided
+     * edge and propagateCell() for each dirty cell.
+     */
+    class ColoringPropagator
+    {
+    public:
+        /** @brief Cell pairs whose known relations justify one deduction */
+        struct Relations
+        {
+            std::pair<int, int> pairs[8];
+            int count = 0;
+
+            void add(int a, int b) { pairs[count++] = {a, b}; }
+        };
+
+        ColoringPropagator(const std::vector<int> &clues,
+                           const std::vector<Edge> &edges,
+                           const std::vector<std::vector<int>> &cellEdges);
+
+        /** @brief The edge's cell on the given side, -1 mapped to the outside */
+        int colorCell(const State &state, int cell) const { return cell < 0 ? state.getOutsideCell() : cell; }
+
+        /**
+         * @brief Merge the colors of a newly decided edge's cells
+         *
+         * Marks the cells whose edges may now be fixed (and the clue cells
+         * next to them) dirty. Call after the edge is on the trail; undo
+         * with State::undoColors.
+         * @return false if the edge contradicts the known relation
+         */
+        bool mergeEdge(State &state, int edgeIdx, int value) const;
+
+        /**
+         * @brief Merge the colors of two cells (outside included) directly
+         * @param differ 1 if the cells get different colors
+         *
+         * Marks cells dirty as mergeEdge does. The merge is logged against
+         * the current trail size, so a caller that decides colors without
+         * an edge undoes it with State::undoColorMerges.
+         * @return false if it contradicts the known relation
+         */
+        bool mergeCells(State &state, int cellA, int cellB, int differ) const;
+
+        /**
+         * @brief Color deductions for one cell
+         * @param force Callback (edgeIdx, value, const Relations &) -> bool
+         *        applying a forced edge
+         * @param conflict Callback (const Relations &) for a clue no color
+         *        choice can meet
+         * @return false on contradiction
+         */
+        template <typename Force, typename Conflict>
+        bool propagateCell(State &state, int cellIdx, Force &&force, Conflict &&conflict) const;
+
+    private:
+        const std::vector<int> &clues;
+        const std::vector<Edge> &edges;
+        const std::vector<std::vector<int>> &cellEdges;
+    };
+
+    template <typename Force, typename Conflict>
+    bool ColoringPropagator::propagateCell(State &state, int cellIdx, Force &&force, Conflict &&conflict) const
+    {
+        auto otherCell = [&](int eidx)
+        {
+            const Edge &e = edges[eidx];
+            return colorCell(state, e.cellA == cellIdx ? e.cellB : e.cellA);
+        };
+
+        int parity;
+        int root = state.findColor(cellIdx, parity);
+        for (int eidx : cellEdges[cellIdx])
+        {
+            int otherParity;
+            if (state.getEdgeState(eidx) != 0 || state.findColor(otherCell(eidx), otherParity) != root)
+                continue;
+            Relations why;
+            why.add(cellIdx, otherCell(eidx));
+            if (!force(eidx, (parity != otherParity) ? 1 : -1, why))
+                return false;
+        }
+
+        int clue = clues[cellIdx];
+        if (clue < 0 || state.getCellUndecided(cellIdx) == 0)
+            return true;
+
+        // Group the undecided neighbours by set. Relation t between this
+        // cell and a set makes the set's members of parity != t ON, so the
+        // set adds count[g][t ^ 1] ON edges
+        Relations why;
+        int groupRoot[4], groupFirst[4], count[4][2] = {}, groups = 0;
+        int edgeGroup[4], edgeParity[4], edgeIdx[4], undecided = 0;
+        for (int eidx : cellEdges[cellIdx])
+        {
+            int other = otherCell(eidx);
+            if (state.getEdgeState(eidx) != 0)
+            {
+                why.add(cellIdx, other);
+                continue;
+            }
+            int otherParity;
+            int otherRoot = state.findColor(other, otherParity);
+            int g = 0;
+            while (g < groups && groupRoot[g] != otherRoot)
+                ++g;
+            if (g == groups)
+            {
+                groupRoot[groups] = otherRoot;
+                groupFirst[groups++] = other;
+            }
+            else
+                why.add(groupFirst[g], other);
+            count[g][otherParity]++;
+            edgeGroup[undecided] = g;
+            edgeParity[undecided] = otherParity;
+            edgeIdx[undecided++] = eidx;
+        }
+
+        int feasible[4] = {};
+        bool any = false;
+        int onCount = state.getCellEdgeCount(cellIdx);
+        for (int choice = 0; choice < (1 << groups); ++choice)
+        {
+            int total = onCount;
+            for (int g = 0; g < groups; ++g)
+                total += count[g][((choice >> g) & 1) ^ 1];
+            if (total != clue)
+                continue;
+            any = true;
+            for (int g = 0; g < groups; ++g)
+                feasible[g] |= 1 << ((choice >> g) & 1);
+        }
+        if (!any)
+        {
+            conflict(why);
+            return false;
+        }
+
+        for (int i = 0; i < undecided; ++i)
+        {
+            int f = feasible[edgeGroup[i]];
+            if (f == 3 || state.getEdgeState(edgeIdx[i]) != 0)
+                continue;
+            int t = (f == 1) ? 0 : 1;
+            if (!force(edgeIdx[i], (t != edgeParity[i]) ? 1 : -1, why))
+                return false;
+        }
+        return true;
+    }
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_COLORING_PROPAGATOR_H
@@ -2,28 +2,42 @@
 #define SLITHERLINK_SOLVER_GRAPHBUILDER_H
 
 #include "core/Grid.h"
-#include <map>
-#include <utility>
+#include "core/Edge.h"
+#include <vector>
 
 namespace slitherlink
 {
 
     /**
-     * @brief Builds edge index mappings for the puzzle graph (SOLID architecture)
+     * @brief Builds the edge graph of a puzzle (SOLID architecture)
      *
-     * Part of planned SOLID refactoring - not currently used.
+     * Same numbering as Solver::buildEdges: horizontal edges row by row,
+     * then vertical ones. The builder keeps a copy of the grid, and the
+     * search components keep references into it, so it must outlive them.
      */
     class GraphBuilder
     {
     private:
-        std::map<std::pair<int, int>, int> horizEdgeIndex;
-        std::map<std::pair<int, int>, int> vertEdgeIndex;
+        Grid grid;
+        int numPoints = 0;
+        std::vector<int> horizEdgeIndex; ///< r * m + c -> edge index
+        std::vector<int> vertEdgeIndex;  ///< r * (m + 1) + c -> edge index
+        std::vector<Edge> edges;
+        std::vector<std::vector<int>> cellEdges;
+        std::vector<std::vector<int>> pointEdges;
+        std::vector<int> clueCells;
 
     public:
         void buildGraph(const Grid &grid);
 
-        const std::map<std::pair<int, int>, int> &getHorizEdgeIndex() const { return horizEdgeIndex; }
-        const std::map<std::pair<int, int>, int> &getVertEdgeIndex() const { return vertEdgeIndex; }
+        const Grid &getGrid() const { return grid; }
+        int getNumPoints() const { return numPoints; }
+        const std::vector<int> &getHorizEdgeIndex() const { return horizEdgeIndex; }
+        const std::vector<int> &getVertEdgeIndex() const { return vertEdgeIndex; }
+        const std::vector<Edge> &getEdges() const { return edges; }
+        const std::vector<std::vector<int>> &getCellEdges() const { return cellEdges; }
+        const std::vector<std::vector<int>> &getPointEdges() const { return pointEdges; }
+        const std::vector<int> &getClueCells() const { return clueCells; }
     };
 
 } // namespace slitherlink
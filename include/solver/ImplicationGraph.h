@@ -0,0 +1,95 @@
+#ifndef SLITHERLINK_IMPLICATION_GRAPH_H
+#define SLITHERLINK_IMPLICATION_GRAPH_H
+
+#include "State.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Binary implications between undecided edges (a 2-SAT layer)
+     *
+     * Built from a state: a clue cell or degree-1 point that needs exactly
+     * one more ON edge gives "a ON => b OFF" for every pair of its
+     * undecided edges, one that can drop exactly one more gives "a OFF =>
+     * b ON", and a degree-0 point with two undecided edges makes them
+     * equal. Literals are the two values of each undecided edge.
+     *
+     * Analysis condenses the graph into strongly connected components
+     * (equivalent literals) and computes, per component, the set of
+     * literals it implies. A literal that implies both values of some edge
+     * fails, so its negation is forced; an edge whose two values both fail
+     * is a contradiction. Each arc remembers the cell or point it came
+     * from, so a deduction is explained by the decided edges of the
+     * constraints on one implication path.
+     *
+     * Not thread-safe: give each thread its own copy.
+     */
+    class ImplicationGraph
+    {
+    public:
+        ImplicationGraph(const std::vector<int> &clues,
+                         const std::vector<std::vector<int>> &cellEdges,
+                         const std::vector<std::vector<int>> &pointEdges);
+
+        /**
+         * @brief Rebuild the graph from the state and find failed literals
+         * @return false if some edge is forced both ways
+         */
+        bool analyze(const State &state);
+
+        /** @brief Edges fixed by the last analysis: (edge, value) */
+        const std::vector<std::pair<int, int>> &getForced() const { return forced; }
+
+        /** @brief Decided edges behind getForced()[entry] */
+        void explain(const State &state, size_t entry, std::vector<int> &out);
+
+        /** @brief Decided edges behind the contradiction of a failed analysis */
+        void explainConflict(const State &state, std::vector<int> &out);
+
+        size_t getArcCount() const { return arcTo.size(); }
+        size_t getEquivalentLiterals() const { return equivalent; }
+
+    private:
+        const std::vector<int> &clues;
+        const std::vector<std::vector<int>> &cellEdges;
+        const std::vector<std::vector<int>> &pointEdges;
+        size_t edgeCount = 0;
+
+        // Literal 2v is variable v ON, 2v + 1 OFF; variables are the
+        // undecided edges
+        std::vector<int> varOf, edgeOf;
+
+        // Arcs in CSR form by source literal; arcSource is the cell, or
+        // cells + point, the implication came from
+        std::vector<int> arcStart, arcTo, arcSource;
+        std::vector<std::pair<int, int>> clauseLits;
+        std::vector<int> clauseSource;
+
+        std::vector<int> component;      ///< Per literal, in reverse topological order
+        std::vector<uint64_t> reach;     ///< Per component: literals implied
+        size_t words = 0;
+        size_t equivalent = 0;
+
+        std::vector<std::pair<int, int>> forced;
+        std::vector<int> failedLiteral; ///< Per forced entry: the literal that failed
+        int conflictLiteral = -1;
+
+        // Tarjan, closure and path search scratch
+        std::vector<int> index, low, stack, callStack, nextArc, byComponent;
+        std::vector<int> parent, parentSource, queue, undecided;
+        std::vector<char> onStack, componentFailed;
+        std::vector<int> seen;
+        int epoch = 0;
+
+        void addClause(int a, int b, int source);
+        void condense();
+        void pathReason(const State &state, int literal, std::vector<int> &out);
+    };
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_IMPLICATION_GRAPH_H
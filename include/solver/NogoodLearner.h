@@ -0,0 +1,219 @@
+#ifndef SLITHERLINK_NOGOOD_LEARNER_H
+#define SLITHERLINK_NOGOOD_LEARNER_H
+
+#include "Edge.h"
+#include "State.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Conflict-driven nogood learning for the edge search (CDCL)
+     *
+     * Tracks the decision level and the reason of every assigned edge,
+     * turns propagation conflicts into learned nogoods (sets of edge
+     * assignments that cannot all hold) by first-UIP analysis, and
+     * propagates those nogoods with two watched literals. The caller owns
+     * the State and undoes the trail to levelMark() when backjumping.
+     *
+     * A literal is (edge, value) encoded as edge * 2 + (value == 1 ? 0 : 1).
+     * Single-threaded: one learner per search.
+     */
+    class NogoodLearner
+    {
+    public:
+        enum class ReasonKind : uint8_t
+        {
+            Decision, ///< Branching choice, no reason
+            Cell,     ///< Forced by a clue cell (anchor = cell index)
+            Point,    ///< Forced by a point degree rule (anchor = point index)
+            Nogood,   ///< Forced by a learned nogood (anchor = nogood index)
+            Loop,     ///< Forced by the subloop rule (reason: all earlier ON edges)
+            Explicit  ///< Forced with a recorded set of decided edges (e.g. a bridge's cut)
+        };
+
+        struct Stats
+        {
+            long long conflicts = 0;
+            long long learned = 0;
+            long long backjumps = 0;   ///< Backjumps that skipped at least one level
+            long long levelsSkipped = 0;
+            long long propagations = 0; ///< Edges forced by nogoods
+        };
+
+        NogoodLearner(const std::vector<int> &clues,
+                      const std::vector<Edge> &edges,
+                      const std::vector<std::vector<int>> &cellEdges,
+                      const std::vector<std::vector<int>> &pointEdges);
+
+        static int literal(int edgeIdx, int value) { return edgeIdx * 2 + (value == 1 ? 0 : 1); }
+        static int literalEdge(int lit) { return lit >> 1; }
+        static int literalValue(int lit) { return (lit & 1) ? -1 : 1; }
+
+        // Decision levels: level k starts with the k-th decision
+        int getLevel() const { return (int)levelStart.size(); }
+        void newLevel(const State &state) { levelStart.push_back(state.getTrailSize()); }
+        size_t levelMark(int level) const { return levelStart[level]; }
+        void backjump(int level);
+
+        // Bookkeeping; edgeIdx must be the newest trail entry
+        void noteDecision(const State &state, int edgeIdx);
+        void noteImplied(const State &state, int edgeIdx, ReasonKind kind, int anchor);
+        void noteImpliedBy(const State &state, int edgeIdx, const std::vector<int> &reason);
+
+        // Conflicts: a violated clue cell or point, or an ON edge that just
+        // overflowed one of them
+        void noteConflict(const State &state, ReasonKind kind, int anchor);
+        void noteConflictAt(const State &state, int edgeIdx);
+        // Conflict explained directly by a set of decided edges
+        void noteConflictEdges(const std::vector<int> &edgeSet);
+
+        /**
+         * @brief Decided edges linking cells a and b (-1 = outside) in the
+         * cell adjacency graph: the evidence for their color relation
+         * @param excludeEdge Edge not to use (-1 for none)
+         * @param out Receives the path's edges (appended)
+         * @return false if no such path exists
+         */
+        bool cellPath(const State &state, int a, int b, int excludeEdge, std::vector<int> &out) const;
+
+        /**
+         * @brief First-UIP analysis of the last noted conflict
+         * @param state State at the conflict
+         * @param assertEdge Receives the edge to force after backjumping
+         * @param assertValue Receives its value
+         * @return Level to backjump to (call levelMark/backjump with it)
+         */
+        int analyze(const State &state, int &assertEdge, int &assertValue);
+
+        /**
+         * @brief Learn the nogood "not all current decisions" (used when a
+         * complete assignment fails the loop check or must be blocked after
+         * a solution was stored)
+         * @return Level to backjump to, as for analyze()
+         */
+        int learnDecisionNogood(const State &state, int &assertEdge, int &assertValue);
+
+        int lastNogood() const { return (int)nogoods.size() - 1; }
+
+        /**
+         * @brief Propagate learned nogoods over trail entries not seen yet
+         * @param state Current state
+         * @param assign Callback (edgeIdx, value) -> bool that applies a
+         *        forced edge, typically the solver's applyDecision
+         * @return false on conflict (already noted)
+         */
+        template <typename Assign>
+        bool propagate(State &state, Assign &&assign);
+
+        const Stats &getStats() const { return stats; }
+
+    private:
+        bool isTrue(const State &state, int lit) const { return state.getEdgeState(literalEdge(lit)) == literalValue(lit); }
+        bool isUndecided(const State &state, int lit) const { return state.getEdgeState(literalEdge(lit)) == 0; }
+
+        void reasonEdges(const State &state, int edgeIdx, std::vector<int> &out) const;
+        void constraintEdges(const State &state, ReasonKind kind, int anchor, std::vector<int> &out) const;
+        int addNogood(const State &state, std::vector<int> &lits, bool keep, int &assertEdge, int &assertValue);
+        void reduceDatabase(const State &state);
+
+        const std::vector<int> &clues;
+        const std::vector<Edge> &edges;
+        const std::vector<std::vector<int>> &cellEdges;
+        const std::vector<std::vector<int>> &pointEdges;
+
+        // Per-edge assignment metadata (valid while the edge is decided)
+        std::vector<int> level;
+        std::vector<int> trailPos;
+        std::vector<ReasonKind> reasonKind;
+        std::vector<int> reasonAnchor;
+        std::vector<std::vector<int>> explicitReason; ///< Reason edges of Explicit assignments
+
+        std::vector<size_t> levelStart; ///< Trail size when each level's decision was made
+        size_t propagationHead = 0;     ///< Trail entries below this were checked against nogoods
+
+        std::vector<std::vector<int>> nogoods; ///< Literals; [0] and [1] are watched
+        std::vector<char> permanent;           ///< Decision nogoods; they block stored solutions
+        std::vector<std::vector<int>> watches; ///< Per literal: nogoods watching it
+        size_t maxNogoods = 2000;
+
+        std::vector<int> conflictEdges;
+        std::vector<char> seen;
+        std::vector<int> scratch;
+
+        std::vector<int> borderEdges;          ///< Edges touching the outside
+        mutable std::vector<int> pathVia;      ///< cellPath: edge reaching each cell, -1 if unreached
+        mutable std::vector<int> pathQueue;
+
+        Stats stats;
+    };
+
+    template <typename Assign>
+    bool NogoodLearner::propagate(State &state, Assign &&assign)
+    {
+        while (propagationHead < state.getTrailSize())
+        {
+            int edgeIdx = state.getTrailAt(propagationHead++);
+            int trueLit = literal(edgeIdx, state.getEdgeState(edgeIdx));
+
+            std::vector<int> &watchList = watches[trueLit];
+            size_t keep = 0;
+            for (size_t i = 0; i < watchList.size(); ++i)
+            {
+                int id = watchList[i];
+                std::vector<int> &lits = nogoods[id];
+                if (lits[0] == trueLit)
+                    std::swap(lits[0], lits[1]);
+
+                // Another literal not yet true can take over the watch
+                bool moved = false;
+                for (size_t k = 2; k < lits.size(); ++k)
+                {
+                    if (!isTrue(state, lits[k]))
+                    {
+                        std::swap(lits[1], lits[k]);
+                        watches[lits[1]].push_back(id);
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved)
+                    continue;
+
+                watchList[keep++] = id;
+                int other = lits[0];
+                if (isTrue(state, other))
+                {
+                    for (++i; i < watchList.size(); ++i)
+                        watchList[keep++] = watchList[i];
+                    watchList.resize(keep);
+                    noteConflict(state, ReasonKind::Nogood, id);
+                    return false;
+                }
+                if (isUndecided(state, other))
+                {
+                    int forcedEdge = literalEdge(other);
+                    bool ok = assign(forcedEdge, -literalValue(other));
+                    noteImplied(state, forcedEdge, ReasonKind::Nogood, id);
+                    stats.propagations++;
+                    if (!ok)
+                    {
+                        for (++i; i < watchList.size(); ++i)
+                            watchList[keep++] = watchList[i];
+                        watchList.resize(keep);
+                        noteConflictAt(state, forcedEdge);
+                        return false;
+                    }
+                }
+            }
+            watchList.resize(keep);
+        }
+        return true;
+    }
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_NOGOOD_LEARNER_H
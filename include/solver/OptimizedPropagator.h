@@ -19,12 +19,8 @@ namespace slitherlink
         const std::vector<std::vector<int>> &adjacentEdges;
         const std::vector<std::vector<int>> &pointEdges;
 
-        // Phase 2 optimization: uint8_t queues for cache efficiency
-        mutable std::vector<uint8_t> cellQueue;
-        mutable std::vector<uint8_t> pointQueue;
-        mutable std::vector<uint8_t> edgeQueue;
-
-        // Propagation helpers
+        // Propagation helpers: table lookups on the packed edge codes
+        bool applyRule(State &state, const int *list, unsigned rule) const;
         bool propagateCell(State &state, int cellIdx) const;
         bool propagatePoint(State &state, int pointIdx) const;
         bool propagateEdge(State &state, int edgeIdx) const;
@@ -34,16 +30,11 @@ namespace slitherlink
                             const std::vector<Edge> &e,
                             const std::vector<std::vector<int>> &adjEdges,
                             const std::vector<std::vector<int>> &ptEdges)
-            : grid(g), edges(e), adjacentEdges(adjEdges), pointEdges(ptEdges)
-        {
-            // Pre-allocate queues (Phase 1 optimization)
-            cellQueue.reserve(g.getRows() * g.getCols());
-            pointQueue.reserve((g.getRows() + 1) * (g.getCols() + 1));
-            edgeQueue.reserve(e.size());
-        }
+            : grid(g), edges(e), adjacentEdges(adjEdges), pointEdges(ptEdges) {}
 
         bool propagate(State &state) const override;
         bool applyDecision(State &state, int edgeIdx, int value) const override;
+        void undoDecisions(State &state, size_t trailMark) const override;
     };
 
 } // namespace slitherlink
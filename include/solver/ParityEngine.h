@@ -0,0 +1,128 @@
+#ifndef SLITHERLINK_PARITY_ENGINE_H
+#define SLITHERLINK_PARITY_ENGINE_H
+
+#include "State.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Incremental GF(2) elimination over parity constraints on edges
+     *
+     * Each constraint says the number of ON edges in a set is even or odd:
+     * the loop crosses every line between two rows (or columns) of points
+     * an even number of times, and a clue cell has clue mod 2 ON edges.
+     * The engine keeps them as packed bitset rows in reduced row echelon
+     * form over the edges it has not absorbed yet. Absorbing a decided edge
+     * folds its value into the right-hand sides and re-pivots the one row
+     * that may lose its pivot, logging each word it changes (with the old
+     * pivot and right-hand side of its row) so the newest absorption is
+     * undone exactly. Per edge it keeps the rows that may hold it, so an
+     * absorption only visits those. In reduced form an edge is fixed by the
+     * system exactly when some row holds that edge alone, and an empty row
+     * with odd right-hand side is a contradiction.
+     *
+     * Each row also remembers which original constraints it combines, so a
+     * deduction can be explained by the decided edges of those constraints.
+     * Not thread-safe: give each thread its own copy.
+     */
+    class ParityEngine
+    {
+    public:
+        /**
+         * @brief Eliminate the constraints with no edge decided
+         * @param supports Edges of each constraint
+         * @param odd Per constraint: 1 if the ON count is odd
+         * @param edgeCount Number of edges
+         */
+        ParityEngine(const std::vector<std::vector<int>> &supports,
+                     const std::vector<int> &odd, size_t edgeCount);
+
+        /**
+         * @brief Absorb the state's edge assignment
+         *
+         * Pops absorbed edges the state no longer agrees with (newest first)
+         * and absorbs the state's other decided edges. For a state with the
+         * trail origin of the last sync only its trail is compared; any
+         * other state is compared edge by edge.
+         * @return false if the constraints contradict the assignment
+         */
+        bool sync(const State &state);
+
+        /** @brief Rows holding a single edge: (edge, row), the value is rowOdd(row) */
+        void units(std::vector<std::pair<int, int>> &out) const;
+        bool rowOdd(int row) const { return rhs[row] != 0; }
+        int getConflictRow() const { return conflictRow; }
+
+        /** @brief Decided edges of the constraints combined into a row */
+        void explain(const State &state, int row, std::vector<int> &out) const;
+
+        size_t getRank() const { return rank; }
+
+    private:
+        struct RowUndo
+        {
+            int row;
+            int pivot;
+            uint8_t rhs;
+            size_t words; ///< First of the row's entries in wordLog
+        };
+
+        struct WordUndo
+        {
+            size_t pos; ///< Index into bits
+            uint64_t old;
+        };
+
+        uint64_t *row(int r) { return &bits[(size_t)r * stride]; }
+        const uint64_t *row(int r) const { return &bits[(size_t)r * stride]; }
+        bool has(int r, int edge) const { return (row(r)[edge >> 6] >> (edge & 63)) & 1; }
+        int firstEdge(int r) const;
+        void addRow(int target, int source, bool logged);
+        void setWord(size_t pos, uint64_t word);
+        void save(int r);
+        const std::vector<int> &rowsHolding(int edge);
+        bool absorb(int edge, int value);
+        void popAbsorbed();
+        bool consistent();
+
+        size_t edgeWords;  ///< Words of edge bits per row
+        size_t stride;     ///< Edge words followed by origin words
+        size_t rank = 0;
+        std::vector<std::vector<int>> supports;
+
+        std::vector<uint64_t> bits;
+        std::vector<uint8_t> rhs;
+        std::vector<int> pivot;    ///< Per row: pivot edge, -1 if the row is empty
+        std::vector<int> pivotRow; ///< Per edge: row it pivots, -1 if none
+        int oddEmptyRows = 0;
+        int conflictRow = -1;
+
+        // Per edge: rows that may hold it. Setting a bit adds the row, so
+        // every row holding the edge is listed; rowsHolding drops the rows
+        // that no longer hold it and duplicates (marked with rowSeen)
+        std::vector<std::vector<int>> edgeRows;
+        std::vector<unsigned> rowSeen;
+        unsigned seenStamp = 0;
+        std::vector<int> holding;
+
+        std::vector<signed char> value; ///< Per edge: absorbed value, 0 if not absorbed
+        std::vector<int> absorbed;      ///< Absorbed edges, oldest first
+        std::vector<size_t> logStart;   ///< Per absorbed edge: its first entry in log
+        std::vector<RowUndo> log;
+        std::vector<WordUndo> wordLog;
+
+        // Trail origin of the last synced state; its first baseCount
+        // absorbed edges are the ones decided off the trail, the rest
+        // follow its trail
+        uint64_t origin = 0;
+        size_t baseCount = 0;
+        std::vector<char> onTrail;
+    };
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_PARITY_ENGINE_H
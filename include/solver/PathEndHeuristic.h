@@ -0,0 +1,42 @@
+#ifndef SLITHERLINK_PATH_END_HEURISTIC_H
+#define SLITHERLINK_PATH_END_HEURISTIC_H
+
+#include "IHeuristic.h"
+#include "Edge.h"
+#include <functional>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Grows the loop from the ends of its open segments
+     *
+     * The ends of the State's open ON segments are its degree-1 points.
+     * The most constrained end is extended: the one whose undecided edge
+     * has the best local score (nearly decided clue cells around it), then
+     * the one with fewer undecided edges left. A branch thus either
+     * continues the path or rules that continuation out. Without an open
+     * segment every undecided edge is ranked by local score alone.
+     */
+    class PathEndHeuristic final : public IHeuristic
+    {
+    public:
+        /** @brief Local score of an undecided edge; higher is chosen first */
+        using LocalScore = std::function<int(const State &, int)>;
+
+        PathEndHeuristic(const std::vector<Edge> &edges,
+                         const std::vector<std::vector<int>> &pointEdges,
+                         LocalScore localScore);
+
+        int selectNextEdge(const State &state) const override;
+
+    private:
+        const std::vector<Edge> &edges;
+        const std::vector<std::vector<int>> &pointEdges;
+        LocalScore localScore;
+    };
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_PATH_END_HEURISTIC_H
@@ -0,0 +1,102 @@
+#ifndef SLITHERLINK_PATTERN_LIBRARY_H
+#define SLITHERLINK_PATTERN_LIBRARY_H
+
+#include "State.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Classic clue patterns (adjacent and diagonal 3s, a 3, 2 or 1
+     * in a corner, 0 next to a 1 or 3, lines running into a clue's corner)
+     * compiled against one grid
+     *
+     * Each pattern is a small template of clue cells, edges that must be
+     * ON or OFF, and edges it then fixes. All rotations and reflections
+     * are generated once, and matching them against the clue grid turns
+     * them into flat per-grid tables: edges fixed by clues alone (applied
+     * at load) and, for templates that also need decided edges, instances
+     * indexed by those edges. An edge outside the grid counts as OFF, so a
+     * corner of the grid matches like a corner of OFF edges.
+     *
+     * Read-only after construction; the fixed-edge counter is atomic so
+     * search threads share one library.
+     */
+    class PatternLibrary
+    {
+    public:
+        /**
+         * @brief Match every pattern variant against the clue grid
+         * @param horizEdgeIndex Edge of the horizontal segment (r, c), r <= rows
+         * @param vertEdgeIndex Edge of the vertical segment (r, c), c <= cols
+         */
+        PatternLibrary(int rows, int cols, const std::vector<int> &clues,
+                       const std::vector<int> &horizEdgeIndex,
+                       const std::vector<int> &vertEdgeIndex, size_t edgeCount);
+
+        /** @brief Edges fixed by clues alone: (edge, value) */
+        const std::vector<std::pair<int, int>> &getLoadDeductions() const { return loadDeductions; }
+
+        /**
+         * @brief Apply the instances that a newly decided edge completes
+         * @param force Callback (edgeIdx, value, instance) -> bool for each
+         *        fixed edge not already at that value (it may be decided the
+         *        other way, which is a contradiction)
+         * @return false if force failed
+         */
+        template <typename Force>
+        bool match(const State &state, int edgeIdx, Force &&force) const;
+
+        /** @brief The decided edges an instance needs */
+        void explain(int instance, std::vector<int> &out) const;
+
+        static size_t getVariantCount();
+        size_t getInstanceCount() const { return whenStart.size() - 1; }
+        long long getSearchFixed() const { return searchFixed.load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<std::pair<int, int>> loadDeductions;
+
+        // Instances as flat ranges: whenEdge/whenValue[whenStart[i] ..
+        // whenStart[i + 1]) must hold for thenEdge/thenValue to follow
+        std::vector<int> whenStart, whenEdge;
+        std::vector<int8_t> whenValue;
+        std::vector<int> thenStart, thenEdge;
+        std::vector<int8_t> thenValue;
+
+        // Per edge: instances with a condition on it
+        std::vector<int> watchStart, watchInstance;
+
+        mutable std::atomic<long long> searchFixed{0};
+    };
+
+    template <typename Force>
+    bool PatternLibrary::match(const State &state, int edgeIdx, Force &&force) const
+    {
+        for (int w = watchStart[edgeIdx]; w < watchStart[edgeIdx + 1]; ++w)
+        {
+            int inst = watchInstance[w];
+            bool holds = true;
+            for (int i = whenStart[inst]; i < whenStart[inst + 1] && holds; ++i)
+                holds = state.getEdgeState(whenEdge[i]) == whenValue[i];
+            if (!holds)
+                continue;
+            for (int i = thenStart[inst]; i < thenStart[inst + 1]; ++i)
+            {
+                if (state.getEdgeState(thenEdge[i]) == thenValue[i])
+                    continue;
+                if (!force(thenEdge[i], thenValue[i], inst))
+                    return false;
+                searchFixed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return true;
+    }
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_PATTERN_LIBRARY_H
@@ -0,0 +1,54 @@
+#ifndef SLITHERLINK_SEARCH_POLICIES_H
+#define SLITHERLINK_SEARCH_POLICIES_H
+
+#include "utils/Config.h"
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Heuristic policy of the solver's own score classes
+     *
+     * No heuristic object: selectNextEdge reads the State's score classes
+     * directly. The other heuristic policies are the final IHeuristic
+     * classes, called without a virtual dispatch, and IHeuristic itself,
+     * which picks one from SolverConfig::heuristic at run time.
+     */
+    struct ScoreClasses
+    {
+    };
+
+    /**
+     * @brief Propagation policy running every pass SolverConfig enables
+     *
+     * The local cell, point and loop rules, plus coloring, clue patterns,
+     * windows, bridges, implications and parity as configured.
+     */
+    struct FullPropagation
+    {
+        static constexpr bool optionalPasses = true;
+
+        static bool fits(const SolverConfig &) { return true; }
+    };
+
+    /**
+     * @brief Propagation policy of the local rules alone
+     *
+     * The optional passes are compiled out of the propagation loop, so it
+     * only fits a configuration that turns all of them off.
+     */
+    struct LocalPropagation
+    {
+        static constexpr bool optionalPasses = false;
+
+        static bool fits(const SolverConfig &config)
+        {
+            return !config.enableColoring && !config.enablePatterns && config.windowSize == 0 &&
+                   config.bridgeInterval == 0 && config.implicationInterval == 0 && config.parityInterval == 0 &&
+                   config.engine == "edge";
+        }
+    };
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_SEARCH_POLICIES_H
@@ -3,7 +3,6 @@
 
 #include "IHeuristic.h"
 #include "Edge.h"
-#include "Grid.h"
 #include <vector>
 #include <memory>
 
@@ -16,10 +15,10 @@ namespace slitherlink
      * Implements Phase 2 optimization #11
      * Selects edges that minimize search tree branching
      */
-    class SmartHeuristic : public IHeuristic
+    class SmartHeuristic final : public IHeuristic
     {
     public:
-        SmartHeuristic(const Grid &grid,
+        SmartHeuristic(const std::vector<int> &clues,
                        const std::vector<Edge> &edges,
                        const std::vector<std::vector<int>> &cellEdges,
                        int numPoints);
@@ -30,7 +29,7 @@ namespace slitherlink
         int estimateBranches(const State &state, int edgeIdx) const;
         int scoreCell(const State &state, int cellIdx) const;
 
-        const Grid &grid;
+        const std::vector<int> &clues;
         const std::vector<Edge> &edges;
         const std::vector<std::vector<int>> &cellEdges;
         int numPoints;
@@ -6,64 +6,305 @@
 #include "State.h"
 #include "Solution.h"
 #include "IHeuristic.h"
-#include "IValidator.h"
-#include "IPropagator.h"
+#include "ActivityHeuristic.h"
+#include "PathEndHeuristic.h"
+#include "SmartHeuristic.h"
+#include "ColoringPropagator.h"
+#include "NogoodLearner.h"
+#include "ParityEngine.h"
+#include "ImplicationGraph.h"
+#include "PatternLibrary.h"
+#include "WindowPropagator.h"
+#include "TranspositionTable.h"
+#include "ISearchEngine.h"
+#include "Topology.h"
+#include "SearchPolicies.h"
+#include "utils/Config.h"
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#ifdef USE_TBB
+#include <tbb/concurrent_vector.h>
+#include <tbb/task_arena.h>
+#endif
 
 namespace slitherlink
 {
 
-    struct SolverConfig
-    {
-        int threads = 1;
-        bool findAll = false;
-        bool verbose = false;
-        bool enableParallel = true;
-    };
-
-    class Solver
+    /**
+     * @brief Trail-based backtracking search over the edges of one puzzle
+     *
+     * Builds the edge graph of its grid, propagates the clue, degree and
+     * loop rules (plus the optional components SolverConfig enables) and
+     * searches for one or all solutions, printing each as it is found.
+     * Topology supplies the grid dimensions and the adjacency the search
+     * reads: DynamicTopology builds them from the grid, FixedTopology<N, M>
+     * makes them compile-time constants and constexpr tables.
+     * Heuristic chooses the edges: IHeuristic picks the class from
+     * SolverConfig::heuristic at run time and calls it virtually,
+     * ScoreClasses or a final heuristic class binds it at compile time.
+     * Propagation (FullPropagation or LocalPropagation) fixes which passes
+     * the propagation loop can run.
+     */
+    template <typename Topology, typename Heuristic = IHeuristic, typename Propagation = FullPropagation>
+    class BasicSolver : public ISearchEngine
     {
     private:
-        const Grid &grid;
-        const std::vector<Edge> &edges;
-        const std::vector<std::vector<int>> &adjacentEdges;
-        const std::vector<std::vector<int>> &pointEdges;
+        Grid grid;
+        SolverConfig config;
+        Topology topo;
 
-        // Dependency injection - depend on abstractions, not concretions
-        std::unique_ptr<IHeuristic> heuristic;
-        std::unique_ptr<IValidator> validator;
-        std::unique_ptr<IPropagator> propagator;
+        // Puzzle graph copied from topo by buildEdges for the components
+        // that take vectors: horizontal edges row by row, then vertical
+        // ones; clueCells lists the cells with a clue
+        std::vector<Edge> edges;
+        std::vector<int> horizEdgeIndex;
+        std::vector<int> vertEdgeIndex;
+        std::vector<std::vector<int>> cellEdges;
+        std::vector<std::vector<int>> pointEdges;
+        std::vector<int> clueCells;
 
-        SolverConfig config;
+        // What presolve leaves to the search: the undecided edges and the
+        // clue cells next to one (everything when presolve is off)
+        std::vector<int> openEdges;
+        std::vector<int> openCells;
 
         // Solution tracking
-        mutable std::vector<Solution> solutions;
-        mutable std::atomic<bool> foundSolution{false};
+        bool findAll = false;
+        std::atomic<bool> stopAfterFirst{false};
+        std::mutex solMutex;
+        std::vector<Solution> solutions;
+        std::atomic<int> solutionCount{0};
+
+        // Subtrees above maxParallelDepth may run as parallel tasks on up
+        // to maxThreads threads
+        int maxParallelDepth = 16;
+        std::atomic<int> activeThreads{0};
+        int maxThreads = 4;
+#ifdef USE_TBB
+        std::unique_ptr<tbb::task_arena> arena;
+        tbb::concurrent_vector<Solution> tbbSolutions;
+#endif
+
+        // Edge selection other than the score scan (--heuristic); the color
+        // engine of a race reports its conflicts to its own colorHeuristic.
+        // Both stay empty under ScoreClasses
+        std::unique_ptr<Heuristic> heuristic;
+        std::unique_ptr<Heuristic> colorHeuristic;
+
+        // Active only during searchWithLearning; propagation reports
+        // reasons and conflicts to it
+        NogoodLearner *learner = nullptr;
+
+        // Restart policy: budget of the current run, last value per edge,
+        // and the rotation applied to selectNextEdge's scan order
+        long long restartBudget = 0;
+        std::atomic<long long> restartNodes{0};
+        std::atomic<bool> restartPending{false};
+        mutable std::vector<std::atomic<char>> savedPhase;
+        int tieOffset = 0;
+
+        // Zobrist keys per (edge, value) and the shared table of hashes of
+        // subtrees proven to contain no solution
+        std::vector<uint64_t> zobristKeys;
+        std::unique_ptr<TranspositionTable> deadStates;
+
+        // Inside/outside coloring rules, run from propagateConstraints
+        std::unique_ptr<ColoringPropagator> coloring;
+
+        // Row/column crossing and clue parity system, eliminated once per
+        // run; forceParity works on per-thread copies of it
+        std::unique_ptr<ParityEngine> parity;
+        unsigned parityBuild = 0;
+
+        // Clue patterns compiled against the grid; clue-only matches are
+        // applied to the start state, the rest run from propagateConstraints
+        std::unique_ptr<PatternLibrary> patterns;
+
+        // Supports of every k x k cell window, filtered from
+        // propagateConstraints by the windows of new trail entries
+        std::unique_ptr<WindowPropagator> windows;
+
+        // Binary implications between undecided edges, rebuilt from the
+        // state on each pass; forceImplications works on per-thread copies
+        std::unique_ptr<ImplicationGraph> implications;
+        unsigned implicationBuild = 0;
+        mutable std::atomic<long long> implicationPasses{0};
+        mutable std::atomic<long long> implicationFixed{0};
+
+        // Probing: edges tried per node, adapted to the edges fixed per
+        // probe, and counters for the statistics
+        mutable std::atomic<int> probeBudget{8};
+        mutable std::atomic<long long> probeNodes{0};
+        mutable std::atomic<long long> probeCount{0};
+        mutable std::atomic<long long> probeFailed{0};
+        mutable std::atomic<long long> probeFixed{0};
+
+        // Pattern branching: the undecided edges of the most constrained
+        // clue cell or point and its legal assignments as bit masks over
+        // them, best first
+        struct LocalPatterns
+        {
+            int edges[4];
+            int edgeCount = 0;
+            uint8_t masks[16];
+            int count = 0;
+        };
+        bool branchOnPatterns = false;
+        mutable std::atomic<long long> searchNodes{0};
+
+        // Discrepancy search: the current level (LDS: deviations allowed,
+        // DDS: depth of the deepest one) and whether it cut off a branch
+        int discrepancyLevel = 0;
+        std::atomic<bool> discrepancyCut{false};
+
+        // Setup
+        int calculateOptimalParallelDepth();
+        void buildEdges();
+        State initialState() const;
+
+        // Decisions along the State's trail
+        bool applyDecision(State &state, int edgeIdx, int val) const;
+        void undoDecisions(State &state, size_t trailMark) const;
+        bool imply(State &state, int edgeIdx, int val, NogoodLearner::ReasonKind kind, int anchor) const;
+        bool imply(State &state, int edgeIdx, int val, const std::vector<int> &reason) const;
+        std::vector<int> colorReason(const State &state, const ColoringPropagator::Relations &why) const;
 
         // Search functions
-        void search(State &state);
-        void parallelSearch(State &initialState);
-        bool extractSolution(const State &state, Solution &sol) const;
+        void search(State &state, int depth, size_t mark = 0);
+        void branch(State &state, int edgeIdx, int val, int depth);
+        void expand(State &state, int edgeIdx, int depth);
+        bool selectPatterns(const State &state, LocalPatterns &unit) const;
+        bool assignPattern(State &state, const LocalPatterns &unit, uint8_t mask) const;
+        void expandPatterns(State &state, const LocalPatterns &unit, int depth);
+        void colorSearch(State &state, int depth, size_t mark = 0);
+        int selectColorCell(const State &state, int &differ) const;
+        void raceEngines(State &state);
+        void searchByDiscrepancy(State &state);
+        void discrepancySearch(State &state, int depth, size_t mark, int budget);
+        void searchWithRestarts(State &state);
+        void beginRestart(int restartIdx, std::mt19937 &rng);
+        bool shouldStop() const;
+        void searchWithLearning(State &state);
+        bool propagateWithNogoods(State &state);
+        bool finalCheckAndStore(State &state);
+
+        // Propagation. Subloop pruning works over the State's segment mates,
+        // keepsConnectivity checks that the segments can still be joined
+        bool propagateConstraints(State &state) const;
+        int closingEdge(const State &state, int pointIdx) const;
+        bool loopMayClose(const State &state, int edgeIdx) const;
+        bool keepsConnectivity(const State &state, int edgeIdx) const;
+        bool quickValidityCheck(State &state) const;
+        bool forceBridges(State &state) const;
+        bool forceParity(State &state) const;
+        bool matchPatterns(State &state) const;
+        bool filterWindows(State &state) const;
+        bool forceImplications(State &state) const;
+        bool probeEdge(State &state, int edgeIdx, std::vector<std::pair<int, int>> &fixes) const;
+        bool probe(State &state) const;
+        bool presolve(State &state);
+        void reduceToOpen(const State &state);
+#ifdef USE_TBB
+        void ensureArena();
+#endif
+
+        // Edge selection: the best-scored undecided edge in scan order,
+        // read from the State's score classes
+        template <typename H>
+        std::unique_ptr<H> buildHeuristic();
+        std::unique_ptr<Heuristic> makeHeuristic();
+        void reportConflict(const State &state, size_t trailMark, bool colorEngine = false) const;
+        int scoreEdge(const State &state, int edgeIdx) const;
+        int scoreClass(const State &state, int edgeIdx) const;
+        void refileEdges(State &state) const;
+        int selectNextEdge(State &state) const;
+
+        // The --heuristic a static Heuristic policy stands for; none for
+        // the IHeuristic facade, which reads it
+        static constexpr const char *heuristicName()
+        {
+            if constexpr (std::is_same_v<Heuristic, ScoreClasses>)
+                return "score";
+            else if constexpr (std::is_same_v<Heuristic, SmartHeuristic>)
+                return "smart";
+            else if constexpr (std::is_same_v<Heuristic, ActivityHeuristic>)
+                return "activity";
+            else if constexpr (std::is_same_v<Heuristic, PathEndHeuristic>)
+                return "path";
+            else
+                return nullptr;
+        }
 
     public:
-        Solver(const Grid &g,
-               const std::vector<Edge> &e,
-               const std::vector<std::vector<int>> &adjEdges,
-               const std::vector<std::vector<int>> &ptEdges,
-               std::unique_ptr<IHeuristic> h,
-               std::unique_ptr<IValidator> v,
-               std::unique_ptr<IPropagator> p,
-               const SolverConfig &cfg = SolverConfig())
-            : grid(g), edges(e), adjacentEdges(adjEdges), pointEdges(ptEdges),
-              heuristic(std::move(h)), validator(std::move(v)), propagator(std::move(p)),
-              config(cfg) {}
-
-        std::vector<Solution> solve();
+        /**
+         * @throws std::invalid_argument if Topology does not fit the grid, or
+         * the Heuristic and Propagation policies do not fit the config
+         */
+        explicit BasicSolver(const Grid &g, const SolverConfig &cfg = SolverConfig())
+            : grid(g), config(cfg), topo(g)
+        {
+            if (!fits(cfg))
+                throw std::invalid_argument("solver policies do not fit --heuristic " + cfg.heuristic +
+                                            " and the enabled propagation passes");
+        }
+
+        /** @brief Whether the Heuristic and Propagation policies can run config */
+        static bool fits(const SolverConfig &config)
+        {
+            const char *name = heuristicName();
+            return Propagation::fits(config) && (!name || config.heuristic == name);
+        }
+
+        /**
+         * @brief Search the grid, printing each solution as it is found
+         * @param allSolutions Keep searching after the first solution
+         */
+        void run(bool allSolutions);
+
+        std::vector<Solution> solve(bool allSolutions) override
+        {
+            run(allSolutions);
+            return solutions;
+        }
+        long long getNodes() const override { return searchNodes.load(std::memory_order_relaxed); }
+
+        void printSolution(const Solution &sol) const;
+        void printSolutions() const override;
         const std::vector<Solution> &getSolutions() const { return solutions; }
     };
 
+    using Solver = BasicSolver<DynamicTopology>;
+
+    // Instantiated in Solver.cpp for the policies and sizes SolverFactory
+    // offers
+    extern template class BasicSolver<DynamicTopology>;
+    extern template class BasicSolver<DynamicTopology, ScoreClasses>;
+    extern template class BasicSolver<DynamicTopology, ScoreClasses, LocalPropagation>;
+    extern template class BasicSolver<DynamicTopology, SmartHeuristic>;
+    extern template class BasicSolver<DynamicTopology, ActivityHeuristic>;
+    extern template class BasicSolver<DynamicTopology, PathEndHeuristic>;
+    extern template class BasicSolver<FixedTopology<5, 5>, ScoreClasses>;
+    extern template class BasicSolver<FixedTopology<5, 5>, ScoreClasses, LocalPropagation>;
+    extern template class BasicSolver<FixedTopology<5, 5>, SmartHeuristic>;
+    extern template class BasicSolver<FixedTopology<5, 5>, ActivityHeuristic>;
+    extern template class BasicSolver<FixedTopology<5, 5>, PathEndHeuristic>;
+    extern template class BasicSolver<FixedTopology<7, 7>, ScoreClasses>;
+    extern template class BasicSolver<FixedTopology<7, 7>, ScoreClasses, LocalPropagation>;
+    extern template class BasicSolver<FixedTopology<7, 7>, SmartHeuristic>;
+    extern template class BasicSolver<FixedTopology<7, 7>, ActivityHeuristic>;
+    extern template class BasicSolver<FixedTopology<7, 7>, PathEndHeuristic>;
+    extern template class BasicSolver<FixedTopology<10, 10>, ScoreClasses>;
+    extern template class BasicSolver<FixedTopology<10, 10>, ScoreClasses, LocalPropagation>;
+    extern template class BasicSolver<FixedTopology<10, 10>, SmartHeuristic>;
+    extern template class BasicSolver<FixedTopology<10, 10>, ActivityHeuristic>;
+    extern template class BasicSolver<FixedTopology<10, 10>, PathEndHeuristic>;
+
 } // namespace slitherlink
 
 #endif // SOLVER_H
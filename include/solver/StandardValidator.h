@@ -22,6 +22,7 @@ namespace slitherlink
         // Quick validation helpers
         bool quickValidityCheck(const State &state) const;
         bool isDefinitelyUnsolvable(const State &state) const;
+        bool segmentsJoinable(const State &state) const;
         bool hasCycle(const State &state) const;
         bool checkCellConstraints(const State &state) const;
 
@@ -0,0 +1,193 @@
+#ifndef SLITHERLINK_TOPOLOGY_H
+#define SLITHERLINK_TOPOLOGY_H
+
+#include "Edge.h"
+#include "Grid.h"
+#include "State.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Edge indices around a cell (always four) or a point (two to four)
+     */
+    class EdgeList
+    {
+    public:
+        constexpr EdgeList(const int *ids, int count) : ids(ids), count(count) {}
+
+        constexpr const int *begin() const { return ids; }
+        constexpr const int *end() const { return ids + count; }
+        constexpr const int *data() const { return ids; }
+        constexpr size_t size() const { return (size_t)count; }
+        constexpr int operator[](size_t i) const { return ids[i]; }
+
+    private:
+        const int *ids;
+        int count;
+    };
+
+    /**
+     * @brief Fill a topology's adjacency tables for an n x m grid
+     *
+     * Edges number horizontal ones row by row, then vertical ones. Each
+     * cell lists its four edges and each point up to four (pointDegree of
+     * them), both in edge order; absent neighbor cells are -1. Works on
+     * std::array tables at compile time and std::vector ones at run time.
+     */
+    template <typename Tables>
+    constexpr void fillTopologyTables(Tables &t, int n, int m)
+    {
+        auto pointId = [m](int r, int c)
+        { return r * (m + 1) + c; };
+        auto add = [&t](int idx, const Edge &e)
+        {
+            t.edges[idx] = e;
+            for (int cell : {e.cellA, e.cellB})
+                if (cell >= 0)
+                {
+                    int k = 0;
+                    while (t.cellEdges[4 * cell + k] >= 0)
+                        ++k;
+                    t.cellEdges[4 * cell + k] = idx;
+                }
+            for (int p : {e.u, e.v})
+                t.pointEdges[4 * p + t.pointDegree[p]++] = idx;
+        };
+        for (size_t i = 0; i < t.cellEdges.size(); ++i)
+            t.cellEdges[i] = -1;
+
+        int idx = 0;
+        for (int r = 0; r <= n; ++r)
+            for (int c = 0; c < m; ++c)
+            {
+                t.horizEdgeIndex[r * m + c] = idx;
+                add(idx++, Edge(pointId(r, c), pointId(r, c + 1), (r > 0) ? (r - 1) * m + c : -1,
+                                (r < n) ? r * m + c : -1));
+            }
+        for (int r = 0; r < n; ++r)
+            for (int c = 0; c <= m; ++c)
+            {
+                t.vertEdgeIndex[r * (m + 1) + c] = idx;
+                add(idx++, Edge(pointId(r, c), pointId(r + 1, c), (c > 0) ? r * m + c - 1 : -1,
+                                (c < m) ? r * m + c : -1));
+            }
+    }
+
+    /**
+     * @brief Grid dimensions and adjacency read from the grid at run time
+     *
+     * The solver's loops over edges and points take their bounds from here,
+     * and its hot loops read the edge, cell and point tables through it.
+     */
+    class DynamicTopology
+    {
+    public:
+        explicit DynamicTopology(const Grid &grid) : rows(grid.getRows()), cols(grid.getCols())
+        {
+            tables.edges.resize(edgeCount());
+            tables.cellEdges.resize(4 * (size_t)rows * cols);
+            tables.pointEdges.resize(4 * (size_t)pointCount());
+            tables.pointDegree.assign(pointCount(), 0);
+            tables.horizEdgeIndex.resize((size_t)(rows + 1) * cols);
+            tables.vertEdgeIndex.resize((size_t)rows * (cols + 1));
+            fillTopologyTables(tables, rows, cols);
+        }
+
+        int getRows() const { return rows; }
+        int getCols() const { return cols; }
+        int pointCount() const { return (rows + 1) * (cols + 1); }
+        int cellCount() const { return rows * cols; }
+        size_t edgeCount() const { return (size_t)(rows + 1) * cols + (size_t)rows * (cols + 1); }
+
+        const Edge &edge(int idx) const { return tables.edges[idx]; }
+        EdgeList cellEdges(int cell) const { return {&tables.cellEdges[4 * cell], 4}; }
+        EdgeList pointEdges(int p) const { return {&tables.pointEdges[4 * p], tables.pointDegree[p]}; }
+        int horizEdge(int r, int c) const { return tables.horizEdgeIndex[r * cols + c]; }
+        int vertEdge(int r, int c) const { return tables.vertEdgeIndex[r * (cols + 1) + c]; }
+
+    private:
+        struct Tables
+        {
+            std::vector<Edge> edges;
+            std::vector<int> cellEdges;
+            std::vector<int> pointEdges;
+            std::vector<uint8_t> pointDegree;
+            std::vector<int> horizEdgeIndex;
+            std::vector<int> vertEdgeIndex;
+        };
+
+        int rows;
+        int cols;
+        Tables tables;
+    };
+
+    /**
+     * @brief Grid dimensions and adjacency fixed at compile time
+     *
+     * The same interface as DynamicTopology over constexpr std::array
+     * tables, so the solver's loops over edges and points compile with
+     * constant trip counts and its adjacency reads are static data. The
+     * grid's State fits State's inline block, so it never allocates one.
+     */
+    template <int N, int M>
+    class FixedTopology
+    {
+    public:
+        /** @throws std::invalid_argument for a grid of another size */
+        explicit FixedTopology(const Grid &grid)
+        {
+            if (!fits(grid))
+                throw std::invalid_argument("FixedTopology<" + std::to_string(N) + ", " + std::to_string(M) +
+                                            "> given a " + std::to_string(grid.getRows()) + "x" +
+                                            std::to_string(grid.getCols()) + " grid");
+        }
+
+        static bool fits(const Grid &grid) { return grid.getRows() == N && grid.getCols() == M; }
+
+        static constexpr int getRows() { return N; }
+        static constexpr int getCols() { return M; }
+        static constexpr int pointCount() { return POINTS; }
+        static constexpr int cellCount() { return N * M; }
+        static constexpr size_t edgeCount() { return EDGES; }
+
+        static constexpr const Edge &edge(int idx) { return tables.edges[idx]; }
+        static constexpr EdgeList cellEdges(int cell) { return {&tables.cellEdges[4 * cell], 4}; }
+        static constexpr EdgeList pointEdges(int p) { return {&tables.pointEdges[4 * p], tables.pointDegree[p]}; }
+        static constexpr int horizEdge(int r, int c) { return tables.horizEdgeIndex[r * M + c]; }
+        static constexpr int vertEdge(int r, int c) { return tables.vertEdgeIndex[r * (M + 1) + c]; }
+
+    private:
+        static constexpr size_t EDGES = (size_t)(N + 1) * M + (size_t)N * (M + 1);
+        static constexpr int POINTS = (N + 1) * (M + 1);
+
+        struct Tables
+        {
+            std::array<Edge, EDGES> edges{};
+            std::array<int, 4 * N * M> cellEdges{};
+            std::array<int, 4 * POINTS> pointEdges{};
+            std::array<uint8_t, POINTS> pointDegree{};
+            std::array<int, (N + 1) * M> horizEdgeIndex{};
+            std::array<int, N *(M + 1)> vertEdgeIndex{};
+        };
+
+        static constexpr Tables tables = []
+        {
+            Tables t{};
+            fillTopologyTables(t, N, M);
+            return t;
+        }();
+
+        static_assert(State::blockBytes(EDGES, POINTS, N * M) <= State::INLINE_BYTES,
+                      "a fixed-size grid's State must fit the inline block");
+    };
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_TOPOLOGY_H
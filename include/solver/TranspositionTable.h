@@ -0,0 +1,60 @@
+#ifndef SLITHERLINK_TRANSPOSITION_TABLE_H
+#define SLITHERLINK_TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Fixed-size, lock-free set of Zobrist hashes of dead subtrees
+     *
+     * The search stores the hash of a propagated state once its whole
+     * subtree has been explored without a solution; a later path reaching
+     * the same edge assignment is cut off. Entries are single 64-bit words
+     * in 4-way buckets (one bucket per 32 bytes), written with relaxed
+     * atomics, so TBB workers share the table without locks. A full bucket
+     * overwrites one slot chosen by the hash. Hash 0 marks an empty slot.
+     */
+    class TranspositionTable
+    {
+    public:
+        /**
+         * @brief Allocate the largest power-of-two bucket count within budget
+         * @param budgetBytes Memory budget (at least one bucket is used)
+         */
+        explicit TranspositionTable(size_t budgetBytes);
+
+        /** @brief True if the hash was recorded as dead (counts hit/miss) */
+        bool probe(uint64_t hash) const;
+
+        /** @brief Record the hash as a dead subtree */
+        void store(uint64_t hash);
+
+        void clear();
+
+        size_t getCapacity() const { return (mask + 1) * WAYS; }
+        size_t getBytes() const { return getCapacity() * sizeof(uint64_t); }
+        long long getHits() const { return hits.load(std::memory_order_relaxed); }
+        long long getMisses() const { return misses.load(std::memory_order_relaxed); }
+        long long getStores() const { return stores.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_t WAYS = 4;
+
+        std::atomic<uint64_t> *bucket(uint64_t hash) const { return &slots[(hash & mask) * WAYS]; }
+
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+        size_t mask = 0; ///< Bucket count - 1
+
+        mutable std::atomic<long long> hits{0};
+        mutable std::atomic<long long> misses{0};
+        std::atomic<long long> stores{0};
+    };
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_TRANSPOSITION_TABLE_H
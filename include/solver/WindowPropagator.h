@@ -0,0 +1,134 @@
+#ifndef SLITHERLINK_WINDOW_PROPAGATOR_H
+#define SLITHERLINK_WINDOW_PROPAGATOR_H
+
+#include "State.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace slitherlink
+{
+
+    /**
+     * @brief Generalized arc consistency over k x k cell windows
+     *
+     * A window's edges are all edges of its k x k cells. Its supports are
+     * the assignments of those edges that meet every clue in the window,
+     * give no point more than two ON edges, and give a point whose edges
+     * all lie in the window degree 0 or 2. Supports are enumerated once per
+     * kind of window (clues and closed points) and shared between windows
+     * of the same kind.
+     *
+     * Filtering keeps the supports that agree with the window's decided
+     * edges; an undecided edge with the same value in all of them is
+     * forced, and no support left is a contradiction. Nothing is stored
+     * per state: the surviving set is the supports matching the decided
+     * edges, so undoing decisions needs no log. Supports grow quickly with
+     * k (2 is cheap, 3 is much stronger but slow). The solver revisits
+     * only the windows of newly decided edges through windowsOf() and
+     * filter().
+     */
+    class WindowPropagator
+    {
+    public:
+        static constexpr int MAX_SIZE = 3; ///< 2k(k + 1) edges fit a 32-bit support
+
+        /**
+         * @param size Window side k, clamped to the grid
+         * @param horizEdgeIndex Edge of the horizontal segment (r, c), r <= rows
+         * @param vertEdgeIndex Edge of the vertical segment (r, c), c <= cols
+         */
+        WindowPropagator(int rows, int cols, const std::vector<int> &clues,
+                         const std::vector<int> &horizEdgeIndex,
+                         const std::vector<int> &vertEdgeIndex,
+                         const std::vector<std::vector<int>> &pointEdges, size_t edgeCount,
+                         int size = 2);
+
+        /** @brief Windows containing the edge, as [first, last) */
+        std::pair<const int *, const int *> windowsOf(int edgeIdx) const
+        {
+            return {edgeWindows.data() + edgeWindowStart[edgeIdx],
+                    edgeWindows.data() + edgeWindowStart[edgeIdx + 1]};
+        }
+
+        /**
+         * @brief Filter one window's supports by its decided edges
+         * @param force Callback (edgeIdx, value) -> bool for each undecided
+         *        edge fixed in every surviving support
+         * @param conflict Callback () for a window with no support left
+         * @return false on contradiction
+         */
+        template <typename Force, typename Conflict>
+        bool filter(const State &state, int window, Force &&force, Conflict &&conflict) const;
+
+        /** @brief The decided edges a window's deductions rest on */
+        void explain(const State &state, int window, std::vector<int> &out) const;
+
+        int getSize() const { return size; }
+        size_t getWindowCount() const { return windowKind.size(); }
+        size_t getSupportCount() const;
+        long long getForced() const { return forced.load(std::memory_order_relaxed); }
+
+    private:
+        int size;
+        int edgesPerWindow = 0;
+
+        // windowEdge[w * edgesPerWindow + i] is local edge i of window w;
+        // bit i of a support is that edge ON
+        std::vector<int> windowEdge;
+        std::vector<int> windowKind;
+        std::vector<std::vector<uint32_t>> kindSupports;
+
+        // Per edge: windows containing it
+        std::vector<int> edgeWindowStart, edgeWindows;
+
+        mutable std::atomic<long long> forced{0};
+    };
+
+    template <typename Force, typename Conflict>
+    bool WindowPropagator::filter(const State &state, int window, Force &&force, Conflict &&conflict) const
+    {
+        const int *we = windowEdge.data() + (size_t)window * edgesPerWindow;
+        uint32_t decided = 0, on = 0;
+        for (int i = 0; i < edgesPerWindow; ++i)
+        {
+            int code = state.getEdgeCode(we[i]);
+            decided |= (uint32_t)(code != 0) << i;
+            on |= (uint32_t)(code == 1) << i;
+        }
+        uint32_t full = (edgesPerWindow == 32) ? ~0u : (1u << edgesPerWindow) - 1;
+        // A fully decided window already passed the cell and point rules
+        if (decided == full)
+            return true;
+
+        uint32_t allOn = full, allOff = full;
+        bool supported = false;
+        for (uint32_t s : kindSupports[windowKind[window]])
+        {
+            if ((s & decided) != on)
+                continue;
+            allOn &= s;
+            allOff &= ~s;
+            supported = true;
+        }
+        if (!supported)
+        {
+            conflict();
+            return false;
+        }
+
+        uint32_t fixed = (allOn | allOff) & ~decided;
+        for (; fixed; fixed &= fixed - 1)
+        {
+            int bit = __builtin_ctz(fixed);
+            if (!force(we[bit], (allOn >> bit & 1) ? 1 : -1))
+                return false;
+            forced.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+} // namespace slitherlink
+
+#endif // SLITHERLINK_WINDOW_PROPAGATOR_H
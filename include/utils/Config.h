@@ -1,18 +1,57 @@
 #ifndef SLITHERLINK_CONFIG_H
 #define SLITHERLINK_CONFIG_H
 
+#include <cstddef>
+#include <string>
+
 namespace slitherlink
 {
 
     /**
-     * @brief Configuration settings (SOLID architecture)
+     * @brief Search settings, filled from the command line
      *
-     * Part of planned SOLID refactoring - not currently used.
+     * Single Responsibility: configuration parsing and validation. The
+     * defaults are the plain parallel edge search with coloring, parity,
+     * patterns and presolve on.
      */
-    class Config
+    struct SolverConfig
     {
-    public:
-        // Placeholder for configuration settings
+        int threads = 0;             ///< Worker threads (0 = all cores)
+        bool findAll = false;        ///< Keep searching after the first solution
+        bool verbose = false;
+        bool enableParallel = true;  ///< Hand subtrees near the root to other threads
+        bool enableLearning = false; ///< Sequential CDCL search with nogood learning
+        bool enableRestarts = false; ///< Luby restarts, randomized ties, phase saving
+        int restartUnit = 100;       ///< Nodes (or conflicts when learning) per Luby unit
+        unsigned randomSeed = 1;     ///< Seed for restart tie-breaking
+        size_t ttBudgetMB = 0;       ///< Dead-subtree transposition table size (0 = off)
+        int bridgeInterval = 4;      ///< Trail growth between bridge passes (0 = off)
+        bool enableColoring = true;  ///< Inside/outside cell coloring propagation
+        int parityInterval = 16;     ///< Trail growth between parity passes (0 = off)
+        bool enablePatterns = true;  ///< Clue pattern library at load and during search
+        int windowSize = 0;          ///< k x k window consistency (0 = off)
+        int implicationInterval = 0; ///< Trail growth between implication graph passes (0 = off)
+        int probeDepth = 0;          ///< Failed-literal probing above this search depth (0 = off)
+        bool enablePresolve = true;  ///< Propagation and parallel probing before the search
+        std::string heuristic = "score"; ///< Edge selection: score, smart, activity or path
+        double activityDecay = 0.95;     ///< Activity kept per conflict by "activity"
+        std::string branching = "edge";  ///< Branch on one edge, or "pattern": a cell's or point's local patterns
+        std::string engine = "edge";     ///< Decide edges, cell colors ("color"), or "race" both
+        std::string discrepancy = "off"; ///< First-solution discrepancy search: off, lds or dds
+        bool discrepancyWaves = false;   ///< Run each discrepancy level's branches as parallel tasks
+
+        /**
+         * @brief Check the settings
+         * @throws std::invalid_argument naming the first setting out of range
+         */
+        void validate() const;
+
+        /**
+         * @brief Parse the solver flags (arguments that are not flags, such
+         * as the puzzle file, are skipped) and validate the result
+         * @throws std::invalid_argument on a bad value
+         */
+        static SolverConfig fromCommandLine(int argc, char *argv[]);
     };
 
 } // namespace slitherlink
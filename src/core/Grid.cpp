@@ -20,6 +20,8 @@ namespace slitherlink
 
     void Grid::setClue(int row, int col, int value)
     {
+        if (value < -1 || value > 3)
+            throw std::invalid_argument("clue must be -1 (none) or 0-3, got " + std::to_string(value));
         if (row >= 0 && row < n && col >= 0 && col < m)
             clues[cellIndex(row, col)] = value;
     }
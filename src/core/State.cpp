@@ -1,17 +1,487 @@
 #include "core/State.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace slitherlink
 {
 
+    uint64_t State::nextTrailOrigin()
+    {
+        static std::atomic<uint64_t> origins{0};
+        return ++origins;
+    }
+
+    State::State(const State &other)
+        : edgeCount(other.edgeCount), pointCount(other.pointCount),
+          cellCount(other.cellCount), hash(other.hash), trailOrigin(other.trailOrigin),
+          openSegments(other.openSegments), closedLoops(other.closedLoops),
+          unsatisfiedClues(other.unsatisfiedClues), segmentsStarted(other.segmentsStarted),
+          reachMark(other.reachMark), reachSegments(other.reachSegments), bridgeMark(other.bridgeMark), parityMark(other.parityMark), patternMark(other.patternMark), windowMark(other.windowMark), implicationMark(other.implicationMark),
+          classWordCount(other.classWordCount), classMapWords(other.classMapWords), classMask(other.classMask),
+          trail(other.trail), segmentLog(other.segmentLog), colorLog(other.colorLog),
+          dirtyPoints(other.dirtyPoints), dirtyCells(other.dirtyCells),
+          stalePoints(other.stalePoints), staleCells(other.staleCells)
+    {
+        if (other.block)
+        {
+            allocate(other.blockSize);
+            std::memcpy(block, other.block, blockSize);
+            bindLayout();
+        }
+    }
+
+    State::State(State &&other) noexcept
+        : block(other.block), blockSize(other.blockSize), edgeCount(other.edgeCount),
+          pointCount(other.pointCount), cellCount(other.cellCount), hash(other.hash), trailOrigin(other.trailOrigin),
+          openSegments(other.openSegments), closedLoops(other.closedLoops),
+          unsatisfiedClues(other.unsatisfiedClues), segmentsStarted(other.segmentsStarted),
+          reachMark(other.reachMark),
+          reachSegments(other.reachSegments), bridgeMark(other.bridgeMark), parityMark(other.parityMark), patternMark(other.patternMark), windowMark(other.windowMark), implicationMark(other.implicationMark),
+          classWordCount(other.classWordCount), classMapWords(other.classMapWords), classMask(other.classMask),
+          edgeBits(other.edgeBits), classMaps(other.classMaps), classSizes(other.classSizes), pointMate(other.pointMate),
+          colorParent(other.colorParent), colorNext(other.colorNext), colorSize(other.colorSize),
+          pointCounters(other.pointCounters), cellCounters(other.cellCounters),
+          colorParity(other.colorParity), pointDirty(other.pointDirty),
+          cellDirty(other.cellDirty), edgeClass(other.edgeClass), classCounts(other.classCounts),
+          pointStale(other.pointStale), cellStale(other.cellStale), trail(std::move(other.trail)),
+          segmentLog(std::move(other.segmentLog)), colorLog(std::move(other.colorLog)),
+          dirtyPoints(std::move(other.dirtyPoints)), dirtyCells(std::move(other.dirtyCells)),
+          stalePoints(std::move(other.stalePoints)), staleCells(std::move(other.staleCells))
+    {
+        // An inline block cannot be taken over, only copied
+        if (other.block == other.inlineBlock.data())
+        {
+            block = inlineBlock.data();
+            std::memcpy(block, other.block, blockSize);
+            bindLayout();
+        }
+        other.block = nullptr;
+        other.blockSize = 0;
+        other.edgeBits = nullptr;
+        other.pointMate = nullptr;
+        other.colorParent = nullptr;
+        other.colorNext = nullptr;
+        other.colorSize = nullptr;
+        other.pointCounters = nullptr;
+        other.cellCounters = nullptr;
+        other.colorParity = nullptr;
+        other.pointDirty = nullptr;
+        other.cellDirty = nullptr;
+        other.classMaps = nullptr;
+        other.classSizes = nullptr;
+        other.edgeClass = nullptr;
+        other.classCounts = nullptr;
+        other.pointStale = nullptr;
+        other.cellStale = nullptr;
+    }
+
+    State &State::operator=(const State &other)
+    {
+        if (this == &other)
+            return *this;
+
+        // Same-shaped states (the common case during search) reuse the block
+        if (blockSize != other.blockSize)
+        {
+            release();
+            if (other.block)
+                allocate(other.blockSize);
+        }
+        edgeCount = other.edgeCount;
+        pointCount = other.pointCount;
+        cellCount = other.cellCount;
+        hash = other.hash;
+        trailOrigin = other.trailOrigin;
+        openSegments = other.openSegments;
+        closedLoops = other.closedLoops;
+        unsatisfiedClues = other.unsatisfiedClues;
+        segmentsStarted = other.segmentsStarted;
+        reachMark = other.reachMark;
+        reachSegments = other.reachSegments;
+        bridgeMark = other.bridgeMark;
+        parityMark = other.parityMark;
+        patternMark = other.patternMark;
+        windowMark = other.windowMark;
+        implicationMark = other.implicationMark;
+        classWordCount = other.classWordCount;
+        classMapWords = other.classMapWords;
+        classMask = other.classMask;
+        if (other.block)
+        {
+            std::memcpy(block, other.block, blockSize);
+            bindLayout();
+        }
+        trail = other.trail;
+        segmentLog = other.segmentLog;
+        colorLog = other.colorLog;
+        dirtyPoints = other.dirtyPoints;
+        dirtyCells = other.dirtyCells;
+        stalePoints = other.stalePoints;
+        staleCells = other.staleCells;
+        return *this;
+    }
+
+    State &State::operator=(State &&other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        release();
+        block = other.block;
+        blockSize = other.blockSize;
+        edgeCount = other.edgeCount;
+        pointCount = other.pointCount;
+        cellCount = other.cellCount;
+        hash = other.hash;
+        trailOrigin = other.trailOrigin;
+        openSegments = other.openSegments;
+        closedLoops = other.closedLoops;
+        unsatisfiedClues = other.unsatisfiedClues;
+        segmentsStarted = other.segmentsStarted;
+        reachMark = other.reachMark;
+        reachSegments = other.reachSegments;
+        bridgeMark = other.bridgeMark;
+        parityMark = other.parityMark;
+        patternMark = other.patternMark;
+        windowMark = other.windowMark;
+        implicationMark = other.implicationMark;
+        classWordCount = other.classWordCount;
+        classMapWords = other.classMapWords;
+        classMask = other.classMask;
+        edgeBits = other.edgeBits;
+        pointMate = other.pointMate;
+        colorParent = other.colorParent;
+        colorNext = other.colorNext;
+        colorSize = other.colorSize;
+        pointCounters = other.pointCounters;
+        cellCounters = other.cellCounters;
+        colorParity = other.colorParity;
+        pointDirty = other.pointDirty;
+        cellDirty = other.cellDirty;
+        classMaps = other.classMaps;
+        classSizes = other.classSizes;
+        edgeClass = other.edgeClass;
+        classCounts = other.classCounts;
+        pointStale = other.pointStale;
+        cellStale = other.cellStale;
+        trail = std::move(other.trail);
+        segmentLog = std::move(other.segmentLog);
+        colorLog = std::move(other.colorLog);
+        dirtyPoints = std::move(other.dirtyPoints);
+        dirtyCells = std::move(other.dirtyCells);
+        stalePoints = std::move(other.stalePoints);
+        staleCells = std::move(other.staleCells);
+        if (other.block == other.inlineBlock.data())
+        {
+            block = inlineBlock.data();
+            std::memcpy(block, other.block, blockSize);
+            bindLayout();
+        }
+
+        other.block = nullptr;
+        other.blockSize = 0;
+        other.edgeBits = nullptr;
+        other.pointMate = nullptr;
+        other.colorParent = nullptr;
+        other.colorNext = nullptr;
+        other.colorSize = nullptr;
+        other.pointCounters = nullptr;
+        other.cellCounters = nullptr;
+        other.colorParity = nullptr;
+        other.pointDirty = nullptr;
+        other.cellDirty = nullptr;
+        other.classMaps = nullptr;
+        other.classSizes = nullptr;
+        other.edgeClass = nullptr;
+        other.classCounts = nullptr;
+        other.pointStale = nullptr;
+        other.cellStale = nullptr;
+        return *this;
+    }
+
+    State::~State()
+    {
+        release();
+    }
+
+    void State::allocate(size_t bytes)
+    {
+        block = (bytes <= INLINE_BYTES)
+                    ? inlineBlock.data()
+                    : static_cast<uint8_t *>(::operator new(bytes, std::align_val_t(CACHE_LINE)));
+        blockSize = bytes;
+    }
+
+    void State::release()
+    {
+        if (block && block != inlineBlock.data())
+            ::operator delete(block, std::align_val_t(CACHE_LINE));
+        block = nullptr;
+        blockSize = 0;
+        edgeBits = nullptr;
+        pointMate = nullptr;
+        colorParent = nullptr;
+        colorNext = nullptr;
+        colorSize = nullptr;
+        pointCounters = nullptr;
+        cellCounters = nullptr;
+        colorParity = nullptr;
+        pointDirty = nullptr;
+        cellDirty = nullptr;
+        classMaps = nullptr;
+        classSizes = nullptr;
+        edgeClass = nullptr;
+        classCounts = nullptr;
+        pointStale = nullptr;
+        cellStale = nullptr;
+    }
+
+    void State::bindLayout()
+    {
+        size_t edgeBytes = ((edgeCount + 31) / 32) * sizeof(uint64_t);
+        edgeBits = reinterpret_cast<uint64_t *>(block);
+        classMaps = edgeBits + edgeBytes / sizeof(uint64_t);
+        classSizes = reinterpret_cast<uint32_t *>(classMaps + SCORE_CLASSES * classMapWords);
+        size_t colorCount = cellCount + 1;
+        pointMate = reinterpret_cast<int16_t *>(classSizes + SCORE_CLASSES);
+        colorParent = pointMate + pointCount;
+        colorNext = colorParent + colorCount;
+        colorSize = colorNext + colorCount;
+        pointCounters = reinterpret_cast<uint8_t *>(colorSize + colorCount);
+        cellCounters = pointCounters + 2 * pointCount;
+        colorParity = cellCounters + 2 * cellCount;
+        pointDirty = colorParity + colorCount;
+        cellDirty = pointDirty + pointCount;
+        edgeClass = cellDirty + cellCount;
+        classCounts = edgeClass + edgeCount;
+        pointStale = classCounts + SCORE_CLASSES * classWordCount;
+        cellStale = pointStale + pointCount;
+    }
+
+    void State::fileEdge(int idx, int cls)
+    {
+        size_t word = (size_t)idx >> 6;
+        if (edgeClass[idx] != NO_CLASS)
+        {
+            int old = edgeClass[idx];
+            if (--classCounts[old * classWordCount + word] == 0)
+                classMaps[old * classMapWords + (word >> 6)] &= ~(uint64_t(1) << (word & 63));
+            if (--classSizes[old] == 0)
+                classMask &= ~(uint64_t(1) << old);
+        }
+        edgeClass[idx] = (cls < 0) ? NO_CLASS : (uint8_t)cls;
+        if (cls >= 0)
+        {
+            if (classCounts[cls * classWordCount + word]++ == 0)
+                classMaps[cls * classMapWords + (word >> 6)] |= uint64_t(1) << (word & 63);
+            if (classSizes[cls]++ == 0)
+                classMask |= uint64_t(1) << cls;
+        }
+    }
+
+    int State::firstInClass(int cls, int from) const
+    {
+        const uint8_t *counts = classCounts + cls * classWordCount;
+        const uint64_t *map = classMaps + cls * classMapWords;
+        auto scanWord = [&](size_t word, size_t lo) -> int
+        {
+            size_t hi = std::min(edgeCount, (word + 1) * 64);
+            for (size_t i = lo; i < hi; ++i)
+                if (edgeClass[i] == cls)
+                    return (int)i;
+            return -1;
+        };
+        // First non-empty word of the class in [lo, hi)
+        auto nextWord = [&](size_t lo, size_t hi) -> size_t
+        {
+            for (size_t m = lo >> 6; lo < hi; m++, lo = m << 6)
+            {
+                uint64_t bits = map[m] & (~uint64_t(0) << (lo & 63));
+                if (bits)
+                    return std::min(hi, (m << 6) + __builtin_ctzll(bits));
+            }
+            return hi;
+        };
+
+        size_t start = (size_t)from >> 6;
+        if (counts[start])
+        {
+            int edge = scanWord(start, (size_t)from);
+            if (edge >= 0)
+                return edge;
+        }
+        size_t word = nextWord(start + 1, classWordCount);
+        if (word < classWordCount)
+            return scanWord(word, word << 6);
+        // Wrap around: the words up to the start, whose edges precede from
+        word = nextWord(0, start + 1);
+        return (word <= start) ? scanWord(word, word << 6) : -1;
+    }
+
+    void State::clearDirty()
+    {
+        for (int idx : dirtyPoints)
+            pointDirty[idx] = 0;
+        for (int idx : dirtyCells)
+            cellDirty[idx] = 0;
+        dirtyPoints.clear();
+        dirtyCells.clear();
+    }
+
+    void State::linkSegment(int u, int v)
+    {
+        // A fresh point is a segment of its own; an endpoint stands for the
+        // segment it ends
+        bool uEnd = getPointDegree(u) == 1;
+        bool vEnd = getPointDegree(v) == 1;
+        int a = uEnd ? pointMate[u] : u;
+        int b = vEnd ? pointMate[v] : v;
+
+        SegmentUndo undo{(int16_t)a, pointMate[a], (int16_t)b, pointMate[b], 0, 0};
+        if (uEnd && vEnd && a == v)
+        {
+            // u and v end the same segment: the edge closes it into a loop
+            undo.segmentDelta = -1;
+            undo.closedLoop = 1;
+        }
+        else
+        {
+            pointMate[a] = (int16_t)b;
+            pointMate[b] = (int16_t)a;
+            undo.segmentDelta = (int8_t)(1 - uEnd - vEnd);
+            markPointDirty(a);
+            markPointDirty(b);
+        }
+        openSegments += undo.segmentDelta;
+        closedLoops += undo.closedLoop;
+        segmentsStarted += (undo.segmentDelta == 1);
+        segmentLog.push_back(undo);
+    }
+
+    void State::unlinkSegment()
+    {
+        const SegmentUndo &undo = segmentLog.back();
+        pointMate[undo.b] = undo.oldMateB;
+        pointMate[undo.a] = undo.oldMateA;
+        openSegments -= undo.segmentDelta;
+        closedLoops -= undo.closedLoop;
+        segmentsStarted -= (undo.segmentDelta == 1);
+        segmentLog.pop_back();
+    }
+
+    void State::mergeColors(int rootA, int rootB, int parity)
+    {
+        // The smaller set goes below the larger one, keeping finds O(log n);
+        // swapping the two next links splices the member lists
+        if (colorSize[rootA] > colorSize[rootB])
+            std::swap(rootA, rootB);
+        colorParent[rootA] = (int16_t)rootB;
+        colorParity[rootA] = (uint8_t)parity;
+        colorSize[rootB] += colorSize[rootA];
+        std::swap(colorNext[rootA], colorNext[rootB]);
+        colorLog.push_back({(int16_t)rootA, (int16_t)rootB, (uint32_t)trail.size()});
+    }
+
+    void State::undoColors(size_t trailMark)
+    {
+        while (!colorLog.empty() && colorLog.back().stamp > trailMark)
+            popColorMerge();
+    }
+
+    void State::undoColorMerges(size_t logSize)
+    {
+        while (colorLog.size() > logSize)
+            popColorMerge();
+    }
+
+    void State::popColorMerge()
+    {
+        const ColorUndo &undo = colorLog.back();
+        std::swap(colorNext[undo.child], colorNext[undo.parent]);
+        colorSize[undo.parent] -= colorSize[undo.child];
+        colorParity[undo.child] = 0;
+        colorParent[undo.child] = undo.child;
+        colorLog.pop_back();
+    }
+
+    std::vector<char> State::getEdgeStates() const
+    {
+        std::vector<char> edges(edgeCount);
+        for (size_t i = 0; i < edgeCount; ++i)
+            edges[i] = getEdgeState((int)i);
+        return edges;
+    }
+
     void State::initialize(size_t edgeCount, size_t pointCount, size_t cellCount)
     {
-        edgeState.reserve(edgeCount);
-        edgeState.assign(edgeCount, 0);
+        // Every index stored in the block is 16-bit: points (segment mates)
+        // and cells plus the outside (color links). Larger grids would wrap
+        // silently, so refuse them
+        const size_t maxIndex = INT16_MAX;
+        if (pointCount > maxIndex || cellCount + 1 > maxIndex)
+            throw std::length_error("State: " + std::to_string(edgeCount) + " edges, " +
+                                    std::to_string(pointCount) + " points, " +
+                                    std::to_string(cellCount) + " cells exceed the " +
+                                    std::to_string(maxIndex) + " indices of its 16-bit layout");
+
+        this->edgeCount = edgeCount;
+        this->pointCount = pointCount;
+        this->cellCount = cellCount;
+        hash = 0;
+        trailOrigin = nextTrailOrigin();
+        openSegments = 0;
+        closedLoops = 0;
+        unsatisfiedClues = 0;
+        segmentsStarted = 0;
+        reachMark = 0;
+        reachSegments = 0;
+        bridgeMark = 0;
+        parityMark = 0;
+        patternMark = 0;
+        windowMark = 0;
+        implicationMark = 0;
+
+        classWordCount = (edgeCount + 63) / 64;
+        classMapWords = (classWordCount + 63) / 64;
+        classMask = 0;
+
+        size_t bytes = blockBytes(edgeCount, pointCount, cellCount);
+
+        if (blockSize != bytes)
+        {
+            release();
+            allocate(bytes);
+        }
+        std::memset(block, 0, blockSize);
+        bindLayout();
+        for (size_t i = 0; i <= cellCount; ++i)
+        {
+            colorParent[i] = colorNext[i] = (int16_t)i;
+            colorSize[i] = 1;
+        }
+        std::memset(edgeClass, NO_CLASS, edgeCount);
+        trail.clear();
+        trail.reserve(edgeCount);
+        segmentLog.clear();
+        segmentLog.reserve(pointCount);
+        colorLog.clear();
+        colorLog.reserve(cellCount);
 
-        pointDegree.resize(pointCount, 0);
-        pointUndecided.resize(pointCount, 0);
-        cellEdgeCount.resize(cellCount, 0);
-        cellUndecided.resize(cellCount, 0);
+        dirtyPoints.clear();
+        dirtyCells.clear();
+        for (size_t i = 0; i < pointCount; ++i)
+            markPointDirty((int)i);
+        for (size_t i = 0; i < cellCount; ++i)
+            markCellDirty((int)i);
+        stalePoints.clear();
+        staleCells.clear();
+        for (size_t i = 0; i < pointCount; ++i)
+            markPointStale((int)i);
     }
 
 } // namespace slitherlink
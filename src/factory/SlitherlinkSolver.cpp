@@ -7,26 +7,26 @@ namespace slitherlink
 
     SlitherlinkSolver::SlitherlinkSolver(
         const Grid &g,
+        std::unique_ptr<ISearchEngine> e,
+        bool findAllSolutions,
         std::shared_ptr<ISolutionCollector> sc,
-        std::shared_ptr<ISolutionPrinter> sp) : grid(g), solutionCollector(sc), solutionPrinter(sp)
+        std::shared_ptr<ISolutionPrinter> sp) : grid(g), engine(std::move(e)), findAll(findAllSolutions),
+                                                solutionCollector(sc), solutionPrinter(sp)
     {
-        // NOTE: This SOLID architecture is not fully implemented yet
-        // The monolithic main.cpp is currently used instead
-        // TODO: Complete Solver integration when refactoring is done
-        // solver = std::make_unique<Solver>(...);
     }
 
     void SlitherlinkSolver::solve()
     {
-        // TODO: Implement when Solver API is finalized
-        // solver->solve();
+        for (const Solution &sol : engine->solve(findAll))
+            solutionCollector->addSolution(sol);
     }
 
     void SlitherlinkSolver::printResults(std::ostream &out) const
     {
-        // TODO: Implement when solution collection is integrated
-        out << "\nSOLID architecture not yet fully integrated.\n";
-        out << "Please use the monolithic executable instead.\n";
+        const std::vector<Solution> &solutions = solutionCollector->getSolutions();
+        for (const Solution &sol : solutions)
+            solutionPrinter->printSolution(sol, out);
+        solutionPrinter->printSummary(solutions.size(), out);
     }
 
 } // namespace slitherlink
@@ -2,6 +2,7 @@
 #include "io/SolutionCollector.h"
 #include "io/SolutionPrinter.h"
 #include "solver/GraphBuilder.h"
+#include "solver/Solver.h"
 namespace slitherlink
 {
 
@@ -9,6 +10,8 @@ namespace slitherlink
     {
         // SOLID: Dependency Inversion - inject dependencies via interfaces
         auto solutionCollector = std::make_shared<SolutionCollector>(findAll);
+        SolverConfig config;
+        config.findAll = findAll;
 
         // Build graph to get indices for printer
         auto graphBuilder = std::make_shared<GraphBuilder>();
@@ -21,8 +24,45 @@ namespace slitherlink
 
         return std::make_unique<SlitherlinkSolver>(
             grid,
+            createEngine(grid, config),
+            findAll,
             solutionCollector,
             solutionPrinter);
     }
 
+    namespace
+    {
+        // The search with its edge selection and propagation passes bound
+        // at compile time: one instantiation per --heuristic, the score
+        // classes also without the optional passes when all are off
+        template <typename Topology>
+        std::unique_ptr<ISearchEngine> createStaticEngine(const Grid &grid, const SolverConfig &config)
+        {
+            if (config.heuristic == "smart")
+                return std::make_unique<BasicSolver<Topology, SmartHeuristic>>(grid, config);
+            if (config.heuristic == "activity")
+                return std::make_unique<BasicSolver<Topology, ActivityHeuristic>>(grid, config);
+            if (config.heuristic == "path")
+                return std::make_unique<BasicSolver<Topology, PathEndHeuristic>>(grid, config);
+            if (LocalPropagation::fits(config))
+                return std::make_unique<BasicSolver<Topology, ScoreClasses, LocalPropagation>>(grid, config);
+            return std::make_unique<BasicSolver<Topology, ScoreClasses>>(grid, config);
+        }
+    } // namespace
+
+    std::unique_ptr<ISearchEngine> SolverFactory::createEngine(const Grid &grid, const SolverConfig &config,
+                                                               bool fixedSize)
+    {
+        if (fixedSize)
+        {
+            if (FixedTopology<5, 5>::fits(grid))
+                return createStaticEngine<FixedTopology<5, 5>>(grid, config);
+            if (FixedTopology<7, 7>::fits(grid))
+                return createStaticEngine<FixedTopology<7, 7>>(grid, config);
+            if (FixedTopology<10, 10>::fits(grid))
+                return createStaticEngine<FixedTopology<10, 10>>(grid, config);
+        }
+        return createStaticEngine<DynamicTopology>(grid, config);
+    }
+
 } // namespace slitherlink
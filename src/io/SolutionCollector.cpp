@@ -3,20 +3,25 @@
 namespace slitherlink
 {
 
-    void SolutionCollector::addSolution(const Solution &solution)
+    SolutionCollector::SolutionCollector(bool findAllSolutions) : findAll(findAllSolutions)
     {
-        std::lock_guard<std::mutex> lock(mutex);
+    }
 
-        int solNum = ++count;
-        std::cout << "\n=== Solution " << solNum << " found! ===\n"
+    void SolutionCollector::addSolution(const Solution &solution)
+    {
+        solutions.push_back(solution);
+        std::cout << "\n=== Solution " << solutions.size() << " found! ===\n"
                   << std::flush;
+    }
 
-        solutions.push_back(solution);
+    const std::vector<Solution> &SolutionCollector::getSolutions() const
+    {
+        return solutions;
+    }
 
-        if (!findAll)
-        {
-            stopRequested.store(true, std::memory_order_relaxed);
-        }
+    bool SolutionCollector::shouldContinue() const
+    {
+        return findAll || solutions.empty();
     }
 
 } // namespace slitherlink
@@ -3,19 +3,27 @@
 namespace slitherlink
 {
 
-    void SolutionPrinter::print(const Solution &sol, std::ostream &out) const
+    SolutionPrinter::SolutionPrinter(
+        const Grid &g,
+        const std::vector<int> &hIndex,
+        const std::vector<int> &vIndex) : grid(g), horizEdgeIndex(hIndex), vertEdgeIndex(vIndex)
     {
-        int n = grid.n, m = grid.m;
+    }
+
+    void SolutionPrinter::printSolution(const Solution &sol, std::ostream &out) const
+    {
+        int n = grid.getRows(), m = grid.getCols();
+        const std::vector<char> &edgeState = sol.getEdgeState();
 
         auto isHorizOn = [&](int r, int c) -> bool
         {
             int idx = horizEdgeIndex[r * m + c];
-            return sol.edgeState[idx] == 1;
+            return edgeState[idx] == 1;
         };
         auto isVertOn = [&](int r, int c) -> bool
         {
             int idx = vertEdgeIndex[r * (m + 1) + c];
-            return sol.edgeState[idx] == 1;
+            return edgeState[idx] == 1;
         };
 
         for (int r = 0; r <= n; ++r)
@@ -36,7 +44,7 @@ namespace slitherlink
             for (int c = 0; c < m; ++c)
             {
                 vline += (isVertOn(r, c) ? "|" : " ");
-                int clue = grid.clues[grid.cellIndex(r, c)];
+                int clue = grid.getClue(r, c);
                 char ch = ' ';
                 if (clue >= 0)
                     ch = char('0' + clue);
@@ -47,17 +55,18 @@ namespace slitherlink
         }
 
         out << "Cycle (point coordinates row,col):\n";
-        for (size_t i = 0; i < sol.cyclePoints.size(); ++i)
+        const auto &cyclePoints = sol.getCyclePoints();
+        for (size_t i = 0; i < cyclePoints.size(); ++i)
         {
-            auto [r, c] = sol.cyclePoints[i];
+            auto [r, c] = cyclePoints[i];
             out << "(" << r << "," << c << ")";
-            if (i + 1 < sol.cyclePoints.size())
+            if (i + 1 < cyclePoints.size())
                 out << " -> ";
         }
         out << "\n";
     }
 
-    void SolutionPrinter::printSummary(int count, std::ostream &out) const
+    void SolutionPrinter::printSummary(size_t count, std::ostream &out) const
     {
         out << "\n=== SUMMARY ===\n";
         out << "Total solutions found: " << count << "\n";
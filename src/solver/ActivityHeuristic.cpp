@@ -0,0 +1,66 @@
+#include "solver/ActivityHeuristic.h"
+#include <utility>
+
+namespace slitherlink
+{
+
+    namespace
+    {
+        // Activities are scaled down by RESCALE once one passes LIMIT
+        constexpr double LIMIT = 1e100;
+        constexpr double RESCALE = 1e-100;
+    } // namespace
+
+    ActivityHeuristic::ActivityHeuristic(size_t edgeCount, double decay, LocalScore localScore)
+        : activity(edgeCount), decay(decay), localScore(std::move(localScore))
+    {
+        for (auto &a : activity)
+            a.store(0.0, std::memory_order_relaxed);
+    }
+
+    int ActivityHeuristic::selectNextEdge(const State &state) const
+    {
+        // The local score is only needed to break an activity tie
+        int edgeCount = (int)activity.size();
+        int bestEdge = edgeCount, bestScore = 0;
+        double bestActivity = -1.0;
+        for (int i = 0; i < edgeCount; ++i)
+        {
+            if (state.getEdgeState(i) != 0)
+                continue;
+            double a = activity[i].load(std::memory_order_relaxed);
+            if (a < bestActivity)
+                continue;
+            int score = localScore(state, i);
+            if (a > bestActivity || score > bestScore)
+            {
+                bestActivity = a;
+                bestScore = score;
+                bestEdge = i;
+            }
+        }
+        return bestEdge;
+    }
+
+    void ActivityHeuristic::onConflict(const State &state, size_t trailMark)
+    {
+        std::lock_guard<std::mutex> lock(bumpMutex);
+        bool rescale = false;
+        for (size_t pos = trailMark; pos < state.getTrailSize(); ++pos)
+        {
+            auto &a = activity[state.getTrailAt(pos)];
+            double raised = a.load(std::memory_order_relaxed) + bump;
+            a.store(raised, std::memory_order_relaxed);
+            rescale = rescale || raised > LIMIT;
+        }
+        bump /= decay;
+        if (rescale || bump > LIMIT)
+        {
+            for (auto &a : activity)
+                a.store(a.load(std::memory_order_relaxed) * RESCALE, std::memory_order_relaxed);
+            bump *= RESCALE;
+        }
+        conflicts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+} // namespace slitherlink
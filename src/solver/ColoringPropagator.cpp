@@ -0,0 +1,54 @@
+#include "solver/ColoringPropagator.h"
+
+namespace slitherlink
+{
+
+    ColoringPropagator::ColoringPropagator(const std::vector<int> &clues,
+                                           const std::vector<Edge> &edges,
+                                           const std::vector<std::vector<int>> &cellEdges)
+        : clues(clues), edges(edges), cellEdges(cellEdges)
+    {
+    }
+
+    bool ColoringPropagator::mergeEdge(State &state, int edgeIdx, int value) const
+    {
+        const Edge &e = edges[edgeIdx];
+        return mergeCells(state, colorCell(state, e.cellA), colorCell(state, e.cellB), value == 1 ? 1 : 0);
+    }
+
+    bool ColoringPropagator::mergeCells(State &state, int cellA, int cellB, int differ) const
+    {
+        int parityA, parityB;
+        int rootA = state.findColor(cellA, parityA);
+        int rootB = state.findColor(cellB, parityB);
+        if (rootA == rootB)
+            return (parityA ^ parityB) == differ;
+
+        // Edges between the two sets are now fixed: revisit the members of
+        // one set (not the outside's, whose edges are the whole border) and
+        // the clue cells around them
+        int outsideParity;
+        int outsideRoot = state.findColor(state.getOutsideCell(), outsideParity);
+        int revisit = (rootB == outsideRoot ||
+                       (rootA != outsideRoot && state.getColorSetSize(rootA) <= state.getColorSetSize(rootB)))
+                          ? rootA
+                          : rootB;
+        int cell = revisit;
+        do
+        {
+            state.markCellDirty(cell);
+            for (int eidx : cellEdges[cell])
+            {
+                const Edge &near = edges[eidx];
+                int other = (near.cellA == cell) ? near.cellB : near.cellA;
+                if (other >= 0 && clues[other] >= 0)
+                    state.markCellDirty(other);
+            }
+            cell = state.getColorNext(cell);
+        } while (cell != revisit);
+
+        state.mergeColors(rootA, rootB, parityA ^ parityB ^ differ);
+        return true;
+    }
+
+} // namespace slitherlink
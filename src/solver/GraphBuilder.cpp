@@ -2,9 +2,10 @@
 namespace slitherlink
 {
 
-    void GraphBuilder::buildGraph(const Grid &grid)
+    void GraphBuilder::buildGraph(const Grid &g)
     {
-        int n = grid.n, m = grid.m;
+        grid = g;
+        int n = grid.getRows(), m = grid.getCols();
         numPoints = (n + 1) * (m + 1);
         horizEdgeIndex.assign((n + 1) * m, -1);
         vertEdgeIndex.assign(n * (m + 1), -1);
@@ -12,7 +13,7 @@ namespace slitherlink
         pointEdges.assign(numPoints, {});
         edges.clear();
         clueCells.clear();
-        clueCells.reserve(grid.clues.size());
+        clueCells.reserve(grid.getClues().size());
 
         auto pointId = [m](int r, int c)
         { return r * (m + 1) + c; };
@@ -52,8 +53,9 @@ namespace slitherlink
                 idx++;
             }
 
-        for (size_t i = 0; i < grid.clues.size(); ++i)
-            if (grid.clues[i] >= 0)
+        const std::vector<int> &clues = grid.getClues();
+        for (size_t i = 0; i < clues.size(); ++i)
+            if (clues[i] >= 0)
                 clueCells.push_back((int)i);
     }
 
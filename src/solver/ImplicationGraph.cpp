@@ -0,0 +1,301 @@
+#include "solver/ImplicationGraph.h"
+#include <algorithm>
+
+namespace slitherlink
+{
+
+    ImplicationGraph::ImplicationGraph(const std::vector<int> &clues,
+                                       const std::vector<std::vector<int>> &cellEdges,
+                                       const std::vector<std::vector<int>> &pointEdges)
+        : clues(clues), cellEdges(cellEdges), pointEdges(pointEdges)
+    {
+        for (const auto &list : pointEdges)
+            for (int e : list)
+                edgeCount = std::max(edgeCount, (size_t)e + 1);
+    }
+
+    void ImplicationGraph::addClause(int a, int b, int source)
+    {
+        // a or b: not a => b, not b => a
+        clauseLits.push_back({a, b});
+        clauseSource.push_back(source);
+    }
+
+    bool ImplicationGraph::analyze(const State &state)
+    {
+        varOf.assign(edgeCount, -1);
+        edgeOf.clear();
+        for (size_t e = 0; e < edgeCount; ++e)
+            if (state.getEdgeState((int)e) == 0)
+            {
+                varOf[e] = (int)edgeOf.size();
+                edgeOf.push_back((int)e);
+            }
+
+        // Collect the clauses: literal 2v is ON, 2v + 1 OFF
+        clauseLits.clear();
+        clauseSource.clear();
+        auto collect = [&](const std::vector<int> &list)
+        {
+            int on = 0;
+            undecided.clear();
+            for (int e : list)
+            {
+                int val = state.getEdgeState(e);
+                on += val == 1;
+                if (val == 0)
+                    undecided.push_back(2 * varOf[e]);
+            }
+            return on;
+        };
+        auto pairs = [&](int offset, int source)
+        {
+            for (size_t i = 0; i < undecided.size(); ++i)
+                for (size_t j = i + 1; j < undecided.size(); ++j)
+                    addClause(undecided[i] + offset, undecided[j] + offset, source);
+        };
+        int cells = (int)cellEdges.size();
+        for (int cell = 0; cell < cells; ++cell)
+        {
+            if (clues[cell] < 0)
+                continue;
+            int need = clues[cell] - collect(cellEdges[cell]);
+            int free = (int)undecided.size();
+            if (free < 2)
+                continue;
+            if (need == 1)
+                pairs(1, cell); // at most one more ON
+            if (free - need == 1)
+                pairs(0, cell); // at most one more OFF
+        }
+        for (int p = 0; p < (int)pointEdges.size(); ++p)
+        {
+            int deg = collect(pointEdges[p]);
+            if (undecided.size() < 2 || deg == 2)
+                continue;
+            if (deg == 1)
+            {
+                pairs(1, cells + p);
+                if (undecided.size() == 2)
+                    pairs(0, cells + p);
+            }
+            else if (undecided.size() == 2)
+            {
+                // Degree 0 with two edges left: both or neither
+                addClause(undecided[0], undecided[1] + 1, cells + p);
+                addClause(undecided[0] + 1, undecided[1], cells + p);
+            }
+        }
+
+        int literals = 2 * (int)edgeOf.size();
+        arcStart.assign(literals + 1, 0);
+        for (auto [a, b] : clauseLits)
+        {
+            arcStart[(a ^ 1) + 1]++;
+            arcStart[(b ^ 1) + 1]++;
+        }
+        for (int l = 0; l < literals; ++l)
+            arcStart[l + 1] += arcStart[l];
+        arcTo.resize(arcStart[literals]);
+        arcSource.resize(arcStart[literals]);
+        nextArc.assign(arcStart.begin(), arcStart.end() - 1);
+        for (size_t i = 0; i < clauseLits.size(); ++i)
+        {
+            auto [a, b] = clauseLits[i];
+            arcTo[nextArc[a ^ 1]] = b;
+            arcSource[nextArc[a ^ 1]++] = clauseSource[i];
+            arcTo[nextArc[b ^ 1]] = a;
+            arcSource[nextArc[b ^ 1]++] = clauseSource[i];
+        }
+
+        condense();
+
+        // A literal fails when its component implies both values of an edge
+        forced.clear();
+        failedLiteral.clear();
+        conflictLiteral = -1;
+        for (int v = 0; v < literals / 2; ++v)
+        {
+            bool onFails = componentFailed[component[2 * v]];
+            bool offFails = componentFailed[component[2 * v + 1]];
+            if (onFails && offFails)
+            {
+                conflictLiteral = 2 * v;
+                return false;
+            }
+            if (onFails || offFails)
+            {
+                forced.push_back({edgeOf[v], onFails ? -1 : 1});
+                failedLiteral.push_back(onFails ? 2 * v : 2 * v + 1);
+            }
+        }
+        return true;
+    }
+
+    void ImplicationGraph::condense()
+    {
+        // Iterative Tarjan: a component gets its number once every
+        // component it reaches has one, so successors number lower
+        int literals = (int)arcStart.size() - 1;
+        index.assign(literals, -1);
+        low.assign(literals, 0);
+        onStack.assign(literals, 0);
+        component.assign(literals, -1);
+        nextArc.assign(arcStart.begin(), arcStart.end() - 1);
+        stack.clear();
+        int counter = 0, components = 0;
+        equivalent = 0;
+
+        auto visit = [&](int l)
+        {
+            index[l] = low[l] = counter++;
+            stack.push_back(l);
+            onStack[l] = 1;
+            callStack.push_back(l);
+        };
+        for (int root = 0; root < literals; ++root)
+        {
+            if (index[root] >= 0)
+                continue;
+            visit(root);
+            while (!callStack.empty())
+            {
+                int l = callStack.back();
+                if (nextArc[l] < arcStart[l + 1])
+                {
+                    int t = arcTo[nextArc[l]++];
+                    if (index[t] < 0)
+                        visit(t);
+                    else if (onStack[t])
+                        low[l] = std::min(low[l], index[t]);
+                    continue;
+                }
+                callStack.pop_back();
+                if (!callStack.empty())
+                    low[callStack.back()] = std::min(low[callStack.back()], low[l]);
+                if (low[l] != index[l])
+                    continue;
+                size_t size = 0;
+                int member;
+                do
+                {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = 0;
+                    component[member] = components;
+                    size++;
+                } while (member != l);
+                if (size > 1)
+                    equivalent += size;
+                components++;
+            }
+        }
+
+        // Literals grouped by component, then each component's implied set
+        // from its own literals and the (already final) sets it points to
+        byComponent.assign(components + 1, 0);
+        for (int l = 0; l < literals; ++l)
+            byComponent[component[l] + 1]++;
+        for (int c = 0; c < components; ++c)
+            byComponent[c + 1] += byComponent[c];
+        queue.resize(literals);
+        nextArc.assign(byComponent.begin(), byComponent.end() - 1);
+        for (int l = 0; l < literals; ++l)
+            queue[nextArc[component[l]]++] = l;
+
+        words = ((size_t)literals + 63) / 64;
+        reach.assign((size_t)components * words, 0);
+        componentFailed.assign(components, 0);
+        for (int c = 0; c < components; ++c)
+        {
+            uint64_t *set = reach.data() + (size_t)c * words;
+            for (int i = byComponent[c]; i < byComponent[c + 1]; ++i)
+            {
+                int l = queue[i];
+                set[l >> 6] |= 1ull << (l & 63);
+                for (int a = arcStart[l]; a < arcStart[l + 1]; ++a)
+                {
+                    int target = component[arcTo[a]];
+                    if (target == c)
+                        continue;
+                    const uint64_t *other = reach.data() + (size_t)target * words;
+                    for (size_t w = 0; w < words; ++w)
+                        set[w] |= other[w];
+                }
+            }
+            // Both values of an edge share a word: ON at even bits
+            for (size_t w = 0; w < words && !componentFailed[c]; ++w)
+                componentFailed[c] = (set[w] & (set[w] >> 1) & 0x5555555555555555ull) != 0;
+        }
+    }
+
+    void ImplicationGraph::pathReason(const State &state, int literal, std::vector<int> &out)
+    {
+        // Breadth-first from the literal until both values of some edge are
+        // reached, then the constraints on the two paths back
+        int literals = (int)arcStart.size() - 1;
+        if (seen.size() != (size_t)literals)
+            seen.assign(literals, 0);
+        parent.resize(literals);
+        parentSource.resize(literals);
+        if (++epoch == 0)
+        {
+            std::fill(seen.begin(), seen.end(), 0);
+            epoch = 1;
+        }
+
+        queue.clear();
+        queue.push_back(literal);
+        seen[literal] = epoch;
+        parent[literal] = -1;
+        int clash = -1;
+        for (size_t head = 0; head < queue.size() && clash < 0; ++head)
+        {
+            int l = queue[head];
+            for (int a = arcStart[l]; a < arcStart[l + 1] && clash < 0; ++a)
+            {
+                int t = arcTo[a];
+                if (seen[t] == epoch)
+                    continue;
+                seen[t] = epoch;
+                parent[t] = l;
+                parentSource[t] = arcSource[a];
+                queue.push_back(t);
+                if (seen[t ^ 1] == epoch)
+                    clash = t;
+            }
+        }
+
+        int cells = (int)cellEdges.size();
+        for (int end : {clash, clash ^ 1})
+        {
+            for (int l = end; l >= 0 && parent[l] >= 0; l = parent[l])
+            {
+                int source = parentSource[l];
+                const std::vector<int> &list =
+                    source < cells ? cellEdges[source] : pointEdges[source - cells];
+                for (int e : list)
+                    if (state.getEdgeState(e) != 0)
+                        out.push_back(e);
+            }
+        }
+    }
+
+    void ImplicationGraph::explain(const State &state, size_t entry, std::vector<int> &out)
+    {
+        out.clear();
+        pathReason(state, failedLiteral[entry], out);
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    void ImplicationGraph::explainConflict(const State &state, std::vector<int> &out)
+    {
+        out.clear();
+        pathReason(state, conflictLiteral, out);
+        pathReason(state, conflictLiteral ^ 1, out);
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+} // namespace slitherlink
@@ -0,0 +1,410 @@
+#include "solver/NogoodLearner.h"
+#include <algorithm>
+
+namespace slitherlink
+{
+
+    NogoodLearner::NogoodLearner(const std::vector<int> &clues,
+                                 const std::vector<Edge> &edges,
+                                 const std::vector<std::vector<int>> &cellEdges,
+                                 const std::vector<std::vector<int>> &pointEdges)
+        : clues(clues), edges(edges), cellEdges(cellEdges), pointEdges(pointEdges)
+    {
+        size_t edgeCount = edges.size();
+        level.assign(edgeCount, 0);
+        trailPos.assign(edgeCount, 0);
+        reasonKind.assign(edgeCount, ReasonKind::Decision);
+        reasonAnchor.assign(edgeCount, -1);
+        explicitReason.assign(edgeCount, {});
+        watches.assign(edgeCount * 2, {});
+        seen.assign(edgeCount, 0);
+
+        for (size_t i = 0; i < edgeCount; ++i)
+            if (edges[i].cellA < 0 || edges[i].cellB < 0)
+                borderEdges.push_back((int)i);
+        pathVia.assign(cellEdges.size() + 1, -1);
+    }
+
+    void NogoodLearner::backjump(int target)
+    {
+        if (target < getLevel())
+        {
+            if (getLevel() - target > 1)
+            {
+                stats.backjumps++;
+                stats.levelsSkipped += getLevel() - target - 1;
+            }
+            propagationHead = std::min(propagationHead, levelStart[target]);
+            levelStart.resize(target);
+        }
+    }
+
+    void NogoodLearner::noteDecision(const State &state, int edgeIdx)
+    {
+        noteImplied(state, edgeIdx, ReasonKind::Decision, -1);
+    }
+
+    void NogoodLearner::noteImplied(const State &state, int edgeIdx, ReasonKind kind, int anchor)
+    {
+        level[edgeIdx] = getLevel();
+        trailPos[edgeIdx] = (int)state.getTrailSize() - 1;
+        reasonKind[edgeIdx] = kind;
+        reasonAnchor[edgeIdx] = anchor;
+    }
+
+    void NogoodLearner::noteImpliedBy(const State &state, int edgeIdx, const std::vector<int> &reason)
+    {
+        noteImplied(state, edgeIdx, ReasonKind::Explicit, -1);
+        explicitReason[edgeIdx] = reason;
+    }
+
+    void NogoodLearner::constraintEdges(const State &state, ReasonKind kind, int anchor,
+                                        std::vector<int> &out) const
+    {
+        // The assignments that make the cell or point constraint fail
+        out.clear();
+        if (kind == ReasonKind::Cell)
+        {
+            int onCount = state.getCellEdgeCount(anchor);
+            int wanted = (onCount > clues[anchor]) ? 1 : -1;
+            for (int e : cellEdges[anchor])
+                if (state.getEdgeState(e) == wanted)
+                    out.push_back(e);
+        }
+        else if (kind == ReasonKind::Point)
+        {
+            bool overfull = state.getPointDegree(anchor) > 2;
+            for (int e : pointEdges[anchor])
+            {
+                char val = state.getEdgeState(e);
+                if (val == 1 || (!overfull && val == -1))
+                    out.push_back(e);
+            }
+        }
+        else if (kind == ReasonKind::Nogood)
+        {
+            for (int lit : nogoods[anchor])
+                out.push_back(literalEdge(lit));
+        }
+        else if (kind == ReasonKind::Loop)
+        {
+            // Segment structure and clue counts depend on ON edges only
+            for (size_t pos = 0; pos < state.getTrailSize(); ++pos)
+                if (state.getEdgeState(state.getTrailAt(pos)) == 1)
+                    out.push_back(state.getTrailAt(pos));
+        }
+    }
+
+    void NogoodLearner::noteConflict(const State &state, ReasonKind kind, int anchor)
+    {
+        stats.conflicts++;
+        constraintEdges(state, kind, anchor, conflictEdges);
+    }
+
+    void NogoodLearner::noteConflictEdges(const std::vector<int> &edgeSet)
+    {
+        stats.conflicts++;
+        conflictEdges = edgeSet;
+    }
+
+    void NogoodLearner::noteConflictAt(const State &state, int edgeIdx)
+    {
+        const Edge &e = edges[edgeIdx];
+        if (state.getPointDegree(e.u) > 2)
+            noteConflict(state, ReasonKind::Point, e.u);
+        else if (state.getPointDegree(e.v) > 2)
+            noteConflict(state, ReasonKind::Point, e.v);
+        else if (e.cellA >= 0 && clues[e.cellA] >= 0 && state.getCellEdgeCount(e.cellA) > clues[e.cellA])
+            noteConflict(state, ReasonKind::Cell, e.cellA);
+        else if (e.cellB >= 0 && clues[e.cellB] >= 0 && state.getCellEdgeCount(e.cellB) > clues[e.cellB])
+            noteConflict(state, ReasonKind::Cell, e.cellB);
+        else
+        {
+            // Around any closed walk through the cells the colors change an
+            // even number of times: an odd count of ON edges on the edge plus
+            // a path between its cells is a contradiction
+            scratch.clear();
+            int on = state.getEdgeState(edgeIdx) == 1;
+            if (cellPath(state, e.cellA, e.cellB, edgeIdx, scratch))
+                for (int p : scratch)
+                    on += state.getEdgeState(p) == 1;
+            if (!scratch.empty() && on % 2 == 1)
+            {
+                scratch.push_back(edgeIdx);
+                noteConflictEdges(scratch);
+            }
+            else
+                noteConflict(state, ReasonKind::Loop, -1);
+        }
+    }
+
+    bool NogoodLearner::cellPath(const State &state, int a, int b, int excludeEdge, std::vector<int> &out) const
+    {
+        int outside = (int)cellEdges.size();
+        a = (a < 0) ? outside : a;
+        b = (b < 0) ? outside : b;
+        if (a == b)
+            return true;
+
+        pathQueue.assign(1, a);
+        pathVia[a] = -2; // reached, no incoming edge
+        bool found = false;
+        for (size_t head = 0; head < pathQueue.size() && !found; ++head)
+        {
+            int cell = pathQueue[head];
+            for (int eidx : (cell == outside) ? borderEdges : cellEdges[cell])
+            {
+                if (eidx == excludeEdge || state.getEdgeState(eidx) == 0)
+                    continue;
+                const Edge &e = edges[eidx];
+                int next = (e.cellA == (cell == outside ? -1 : cell)) ? e.cellB : e.cellA;
+                next = (next < 0) ? outside : next;
+                if (pathVia[next] != -1)
+                    continue;
+                pathVia[next] = eidx;
+                pathQueue.push_back(next);
+                if (next == b)
+                {
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        if (found)
+        {
+            for (int cell = b; cell != a;)
+            {
+                const Edge &e = edges[pathVia[cell]];
+                out.push_back(pathVia[cell]);
+                int prev = (e.cellA == (cell == outside ? -1 : cell)) ? e.cellB : e.cellA;
+                cell = (prev < 0) ? outside : prev;
+            }
+        }
+        for (int cell : pathQueue)
+            pathVia[cell] = -1;
+        return found;
+    }
+
+    void NogoodLearner::reasonEdges(const State &state, int edgeIdx, std::vector<int> &out) const
+    {
+        // Rebuilt lazily: the same rule over the anchor's edges that were
+        // already decided when edgeIdx was forced
+        out.clear();
+        int anchor = reasonAnchor[edgeIdx];
+        int pos = trailPos[edgeIdx];
+        bool forcedOn = state.getEdgeState(edgeIdx) == 1;
+        auto earlier = [&](int e)
+        { return e != edgeIdx && state.getEdgeState(e) != 0 && trailPos[e] < pos; };
+
+        switch (reasonKind[edgeIdx])
+        {
+        case ReasonKind::Decision:
+            break;
+        case ReasonKind::Cell:
+            // ON: the cell's OFF edges left exactly clue candidates
+            // OFF: the cell's ON edges already met the clue
+            for (int e : cellEdges[anchor])
+                if (earlier(e) && state.getEdgeState(e) == (forcedOn ? -1 : 1))
+                    out.push_back(e);
+            break;
+        case ReasonKind::Point:
+            // ON: one ON edge and every other edge OFF; OFF: two ON edges,
+            // or no ON edge and every other edge OFF (a dead end)
+            for (int e : pointEdges[anchor])
+                if (earlier(e) && (forcedOn || state.getEdgeState(e) == 1))
+                    out.push_back(e);
+            if (!forcedOn && out.empty())
+                for (int e : pointEdges[anchor])
+                    if (earlier(e))
+                        out.push_back(e);
+            break;
+        case ReasonKind::Nogood:
+            for (int lit : nogoods[anchor])
+                if (literalEdge(lit) != edgeIdx)
+                    out.push_back(literalEdge(lit));
+            break;
+        case ReasonKind::Loop:
+            for (int p = 0; p < pos; ++p)
+                if (state.getEdgeState(state.getTrailAt(p)) == 1)
+                    out.push_back(state.getTrailAt(p));
+            break;
+        case ReasonKind::Explicit:
+            out = explicitReason[edgeIdx];
+            break;
+        }
+    }
+
+    int NogoodLearner::analyze(const State &state, int &assertEdge, int &assertValue)
+    {
+        int current = getLevel();
+        std::vector<int> learnt(1, -1);
+        std::vector<int> touched;
+        int pathCount = 0;
+
+        auto visit = [&](int e)
+        {
+            if (seen[e] || level[e] == 0)
+                return;
+            seen[e] = 1;
+            touched.push_back(e);
+            if (level[e] == current)
+                pathCount++;
+            else
+                learnt.push_back(literal(e, state.getEdgeState(e)));
+        };
+
+        for (int e : conflictEdges)
+            visit(e);
+
+        if (pathCount == 0)
+        {
+            // Conflict among lower-level assignments only; fall back to
+            // blocking the current decisions
+            for (int e : touched)
+                seen[e] = 0;
+            return learnDecisionNogood(state, assertEdge, assertValue);
+        }
+
+        // Walk the trail backwards, resolving current-level assignments
+        // until a single one (the first unique implication point) remains
+        size_t idx = state.getTrailSize();
+        int uip = -1;
+        while (true)
+        {
+            do
+            {
+                --idx;
+            } while (!seen[state.getTrailAt(idx)] || level[state.getTrailAt(idx)] != current);
+
+            int e = state.getTrailAt(idx);
+            seen[e] = 0;
+            if (--pathCount == 0)
+            {
+                uip = e;
+                break;
+            }
+            reasonEdges(state, e, scratch);
+            for (int r : scratch)
+                visit(r);
+        }
+
+        for (int e : touched)
+            seen[e] = 0;
+
+        learnt[0] = literal(uip, state.getEdgeState(uip));
+        return addNogood(state, learnt, false, assertEdge, assertValue);
+    }
+
+    int NogoodLearner::learnDecisionNogood(const State &state, int &assertEdge, int &assertValue)
+    {
+        // Newest decision first so it becomes the asserting literal
+        std::vector<int> learnt;
+        for (int lvl = getLevel(); lvl >= 1; --lvl)
+        {
+            int e = state.getTrailAt(levelStart[lvl - 1]);
+            learnt.push_back(literal(e, state.getEdgeState(e)));
+        }
+        if (learnt.empty())
+        {
+            assertEdge = -1;
+            assertValue = 0;
+            return 0;
+        }
+        return addNogood(state, learnt, true, assertEdge, assertValue);
+    }
+
+    int NogoodLearner::addNogood(const State &state, std::vector<int> &lits, bool keep, int &assertEdge, int &assertValue)
+    {
+        // Reduce first so the new nogood keeps its index (lastNogood())
+        if (nogoods.size() >= maxNogoods)
+            reduceDatabase(state);
+
+        stats.learned++;
+        assertEdge = literalEdge(lits[0]);
+        assertValue = -literalValue(lits[0]);
+
+        int target = 0;
+        if (lits.size() > 1)
+        {
+            // Watch the literal from the highest remaining level: it is the
+            // last one to become unassigned when backjumping further
+            size_t best = 1;
+            for (size_t i = 2; i < lits.size(); ++i)
+                if (level[literalEdge(lits[i])] > level[literalEdge(lits[best])])
+                    best = i;
+            std::swap(lits[1], lits[best]);
+            target = level[literalEdge(lits[1])];
+        }
+
+        int id = (int)nogoods.size();
+        nogoods.push_back(lits);
+        permanent.push_back(keep);
+        if (lits.size() > 1)
+        {
+            watches[lits[0]].push_back(id);
+            watches[lits[1]].push_back(id);
+        }
+        return target;
+    }
+
+    void NogoodLearner::reduceDatabase(const State &state)
+    {
+        // Keep decision nogoods, short nogoods and every nogood that is
+        // currently the reason of an assigned edge; drop the longer half of
+        // the rest
+        std::vector<char> locked(nogoods.size(), 0);
+        for (size_t pos = 0; pos < state.getTrailSize(); ++pos)
+        {
+            int e = state.getTrailAt(pos);
+            if (reasonKind[e] == ReasonKind::Nogood)
+                locked[reasonAnchor[e]] = 1;
+        }
+
+        std::vector<int> candidates;
+        for (size_t id = 0; id < nogoods.size(); ++id)
+            if (!locked[id] && !permanent[id] && nogoods[id].size() > 2)
+                candidates.push_back((int)id);
+        std::sort(candidates.begin(), candidates.end(), [&](int a, int b)
+                  { return nogoods[a].size() > nogoods[b].size(); });
+
+        std::vector<char> drop(nogoods.size(), 0);
+        for (size_t i = 0; i < candidates.size() / 2; ++i)
+            drop[candidates[i]] = 1;
+
+        std::vector<int> remap(nogoods.size(), -1);
+        std::vector<std::vector<int>> kept;
+        kept.reserve(nogoods.size());
+        for (size_t id = 0; id < nogoods.size(); ++id)
+        {
+            if (drop[id])
+                continue;
+            remap[id] = (int)kept.size();
+            permanent[remap[id]] = permanent[id];
+            kept.push_back(std::move(nogoods[id]));
+        }
+        nogoods = std::move(kept);
+        permanent.resize(nogoods.size());
+
+        for (size_t pos = 0; pos < state.getTrailSize(); ++pos)
+        {
+            int e = state.getTrailAt(pos);
+            if (reasonKind[e] == ReasonKind::Nogood)
+                reasonAnchor[e] = remap[reasonAnchor[e]];
+        }
+
+        for (auto &list : watches)
+            list.clear();
+        for (size_t id = 0; id < nogoods.size(); ++id)
+        {
+            if (nogoods[id].size() > 1)
+            {
+                watches[nogoods[id][0]].push_back((int)id);
+                watches[nogoods[id][1]].push_back((int)id);
+            }
+        }
+
+        maxNogoods += maxNogoods / 2;
+    }
+
+} // namespace slitherlink
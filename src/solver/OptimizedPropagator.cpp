@@ -1,39 +1,40 @@
 #include "solver/OptimizedPropagator.h"
+#include "solver/LocalRuleTable.h"
 
 using namespace slitherlink;
 
-bool OptimizedPropagator::propagateCell(State &state, int cellIdx) const
+bool OptimizedPropagator::applyRule(State &state, const int *list, unsigned rule) const
 {
-    int clue = grid.getClue(cellIdx / grid.getCols(), cellIdx % grid.getCols());
-    if (clue < 0)
-        return true;
-
-    int onCount = state.getCellEdgeCount(cellIdx);
-    int undecided = state.getCellUndecided(cellIdx);
-
-    // Check validity
-    if (onCount > clue || onCount + undecided < clue)
-    {
+    // Low nibble: edges to force ON, high nibble: OFF
+    if (rule == LocalRules::CONFLICT)
         return false;
+    for (; rule; rule &= rule - 1)
+    {
+        int bit = __builtin_ctz(rule);
+        if (!applyDecision(state, list[bit & 3], (bit < 4) ? 1 : -1))
+            return false;
     }
-
     return true;
 }
 
-bool OptimizedPropagator::propagatePoint(State &state, int pointIdx) const
+bool OptimizedPropagator::propagateCell(State &state, int cellIdx) const
 {
-    int degree = state.getPointDegree(pointIdx);
-    int undecided = state.getPointUndecided(pointIdx);
-
-    // Points can have at most 2 edges
-    if (degree > 2)
-        return false;
+    int clue = grid.getClues()[cellIdx];
+    if (clue < 0)
+        return true;
 
-    // Points with 1 edge must have another (can't have odd degree in a cycle)
-    if (degree == 1 && undecided == 0)
-        return false;
+    const int *list = adjacentEdges[cellIdx].data();
+    auto code = [&state](int eidx)
+    { return state.getEdgeCode(eidx); };
+    return applyRule(state, list, LocalRules::cellRule(clue, LocalRules::key(list, 4, code)));
+}
 
-    return true;
+bool OptimizedPropagator::propagatePoint(State &state, int pointIdx) const
+{
+    const std::vector<int> &list = pointEdges[pointIdx];
+    auto code = [&state](int eidx)
+    { return state.getEdgeCode(eidx); };
+    return applyRule(state, list.data(), LocalRules::pointTable[LocalRules::key(list.data(), (int)list.size(), code)]);
 }
 
 bool OptimizedPropagator::propagateEdge(State &state, int edgeIdx) const
@@ -44,226 +45,17 @@ bool OptimizedPropagator::propagateEdge(State &state, int edgeIdx) const
 
 bool OptimizedPropagator::propagate(State &state) const
 {
-    // Initial validation
-    int numCells = grid.getRows() * grid.getCols();
-    int numPoints = (grid.getRows() + 1) * (grid.getCols() + 1);
-
-    for (int cell = 0; cell < numCells; ++cell)
-    {
-        int clue = grid.getClue(cell / grid.getCols(), cell % grid.getCols());
-        if (clue < 0)
-            continue;
-
-        int onCount = state.getCellEdgeCount(cell);
-        int undecided = state.getCellUndecided(cell);
-        int maxPossible = onCount + undecided;
-
-        if (onCount > clue || maxPossible < clue)
-        {
-            return false;
-        }
-    }
-
-    // Phase 2 optimization: Use uint8_t queues for cache efficiency
-    cellQueue.clear();
-    pointQueue.clear();
-    edgeQueue.clear();
-
-    std::vector<uint8_t> cellQueued(numCells, 0);
-    std::vector<uint8_t> pointQueued(numPoints, 0);
-
-    // Initialize queues with all cells that have clues
-    for (int r = 0; r < grid.getRows(); ++r)
-    {
-        for (int c = 0; c < grid.getCols(); ++c)
-        {
-            int cellIdx = grid.cellIndex(r, c);
-            if (grid.getClue(r, c) >= 0)
-            {
-                cellQueue.push_back(cellIdx);
-                cellQueued[cellIdx] = 1;
-            }
-        }
-    }
-
-    // Initialize with all points
-    for (int i = 0; i < numPoints; ++i)
-    {
-        pointQueue.push_back(i);
-        pointQueued[i] = 1;
-    }
-
-    size_t cellPos = 0, pointPos = 0;
-
-    // Propagation loop
-    while (cellPos < cellQueue.size() || pointPos < pointQueue.size())
+    // Drain only the cells and points touched since the last fixpoint;
+    // applyDecision marks them dirty, so each call costs O(change)
+    while (state.hasDirtyCells() || state.hasDirtyPoints())
     {
-        // Process cells
-        while (cellPos < cellQueue.size())
-        {
-            int cellIdx = cellQueue[cellPos++];
-            cellQueued[cellIdx] = 0;
-
-            int clue = grid.getClue(cellIdx / grid.getCols(), cellIdx % grid.getCols());
-            if (clue < 0)
-                continue;
-
-            int onCount = state.getCellEdgeCount(cellIdx);
-            int undecided = state.getCellUndecided(cellIdx);
-
-            // If all remaining edges must be ON
-            if (onCount + undecided == clue)
-            {
-                for (int eidx : adjacentEdges[cellIdx])
-                {
-                    if (state.getEdgeState(eidx) == 0)
-                    {
-                        if (!applyDecision(state, eidx, 1))
-                        {
-                            return false;
-                        }
-
-                        // Queue affected cells and points
-                        const Edge &e = edges[eidx];
-                        if (e.cellA >= 0 && !cellQueued[e.cellA])
-                        {
-                            if (grid.getClue(e.cellA / grid.getCols(), e.cellA % grid.getCols()) >= 0)
-                            {
-                                cellQueue.push_back(e.cellA);
-                                cellQueued[e.cellA] = 1;
-                            }
-                        }
-                        if (e.cellB >= 0 && !cellQueued[e.cellB])
-                        {
-                            if (grid.getClue(e.cellB / grid.getCols(), e.cellB % grid.getCols()) >= 0)
-                            {
-                                cellQueue.push_back(e.cellB);
-                                cellQueued[e.cellB] = 1;
-                            }
-                        }
-                        if (!pointQueued[e.u])
-                        {
-                            pointQueue.push_back(e.u);
-                            pointQueued[e.u] = 1;
-                        }
-                        if (!pointQueued[e.v])
-                        {
-                            pointQueue.push_back(e.v);
-                            pointQueued[e.v] = 1;
-                        }
-                    }
-                }
-            }
-            // If clue is satisfied, turn off remaining edges
-            else if (onCount == clue && undecided > 0)
-            {
-                for (int eidx : adjacentEdges[cellIdx])
-                {
-                    if (state.getEdgeState(eidx) == 0)
-                    {
-                        state.setEdgeState(eidx, -1);
-                        const Edge &e = edges[eidx];
-                        state.decrementPointUndecided(e.u);
-                        state.decrementPointUndecided(e.v);
-                        if (e.cellA >= 0)
-                            state.decrementCellUndecided(e.cellA);
-                        if (e.cellB >= 0)
-                            state.decrementCellUndecided(e.cellB);
-
-                        if (!pointQueued[e.u])
-                        {
-                            pointQueue.push_back(e.u);
-                            pointQueued[e.u] = 1;
-                        }
-                        if (!pointQueued[e.v])
-                        {
-                            pointQueue.push_back(e.v);
-                            pointQueued[e.v] = 1;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Process points
-        while (pointPos < pointQueue.size())
-        {
-            int ptIdx = pointQueue[pointPos++];
-            pointQueued[ptIdx] = 0;
-
-            int deg = state.getPointDegree(ptIdx);
-            int undecided = state.getPointUndecided(ptIdx);
-
-            // Skip if nothing to propagate
-            if (deg >= 2 || (deg == 0 && undecided == 0))
-            {
-                continue;
-            }
-
-            // Point has 1 ON edge and 1 undecided: must turn ON the undecided
-            if (deg == 1 && undecided == 1)
-            {
-                for (int eidx : pointEdges[ptIdx])
-                {
-                    if (state.getEdgeState(eidx) == 0)
-                    {
-                        if (!applyDecision(state, eidx, 1))
-                        {
-                            return false;
-                        }
-
-                        const Edge &e = edges[eidx];
-                        if (e.cellA >= 0 && !cellQueued[e.cellA])
-                        {
-                            if (grid.getClue(e.cellA / grid.getCols(), e.cellA % grid.getCols()) >= 0)
-                            {
-                                cellQueue.push_back(e.cellA);
-                                cellQueued[e.cellA] = 1;
-                            }
-                        }
-                        if (e.cellB >= 0 && !cellQueued[e.cellB])
-                        {
-                            if (grid.getClue(e.cellB / grid.getCols(), e.cellB % grid.getCols()) >= 0)
-                            {
-                                cellQueue.push_back(e.cellB);
-                                cellQueued[e.cellB] = 1;
-                            }
-                        }
-                        int otherPt = (e.u == ptIdx) ? e.v : e.u;
-                        if (!pointQueued[otherPt])
-                        {
-                            pointQueue.push_back(otherPt);
-                            pointQueued[otherPt] = 1;
-                        }
-                    }
-                }
-            }
-            // Point already has 2 ON edges: turn off all remaining
-            else if (deg == 2 && undecided > 0)
-            {
-                for (int eidx : pointEdges[ptIdx])
-                {
-                    if (state.getEdgeState(eidx) == 0)
-                    {
-                        state.setEdgeState(eidx, -1);
-                        const Edge &e = edges[eidx];
-                        state.decrementPointUndecided(e.u);
-                        state.decrementPointUndecided(e.v);
-                        if (e.cellA >= 0)
-                            state.decrementCellUndecided(e.cellA);
-                        if (e.cellB >= 0)
-                            state.decrementCellUndecided(e.cellB);
+        while (state.hasDirtyCells())
+            if (!propagateCell(state, state.takeDirtyCell()))
+                return false;
 
-                        int otherPt = (e.u == ptIdx) ? e.v : e.u;
-                        if (!pointQueued[otherPt])
-                        {
-                            pointQueue.push_back(otherPt);
-                            pointQueued[otherPt] = 1;
-                        }
-                    }
-                }
-            }
-        }
+        while (state.hasDirtyPoints())
+            if (!propagatePoint(state, state.takeDirtyPoint()))
+                return false;
     }
 
     return true;
@@ -272,11 +64,22 @@ bool OptimizedPropagator::propagate(State &state) const
 bool OptimizedPropagator::applyDecision(State &state, int edgeIdx, int value) const
 {
     state.setEdgeState(edgeIdx, value);
+    state.pushTrail(edgeIdx);
     const Edge &e = edges[edgeIdx];
 
+    // Queue the touched points and clue cells for the next propagate()
+    const std::vector<int> &clues = grid.getClues();
+    state.markPointDirty(e.u);
+    state.markPointDirty(e.v);
+    if (e.cellA >= 0 && clues[e.cellA] >= 0)
+        state.markCellDirty(e.cellA);
+    if (e.cellB >= 0 && clues[e.cellB] >= 0)
+        state.markCellDirty(e.cellB);
+
     if (value == 1)
     {
         // Turn ON
+        state.linkSegment(e.u, e.v);
         state.incrementPointDegree(e.u);
         state.incrementPointDegree(e.v);
         state.decrementPointUndecided(e.u);
@@ -298,21 +101,18 @@ bool OptimizedPropagator::applyDecision(State &state, int edgeIdx, int value) co
         {
             return false;
         }
-        if (e.cellA >= 0)
+        // A closed loop must be the whole answer
+        if (state.getClosedLoops() > 1 || (state.getClosedLoops() == 1 && state.getOpenSegments() > 0))
         {
-            int clue = grid.getClue(e.cellA / grid.getCols(), e.cellA % grid.getCols());
-            if (clue >= 0 && state.getCellEdgeCount(e.cellA) > clue)
-            {
-                return false;
-            }
+            return false;
         }
-        if (e.cellB >= 0)
+        if (e.cellA >= 0 && clues[e.cellA] >= 0 && state.getCellEdgeCount(e.cellA) > clues[e.cellA])
         {
-            int clue = grid.getClue(e.cellB / grid.getCols(), e.cellB % grid.getCols());
-            if (clue >= 0 && state.getCellEdgeCount(e.cellB) > clue)
-            {
-                return false;
-            }
+            return false;
+        }
+        if (e.cellB >= 0 && clues[e.cellB] >= 0 && state.getCellEdgeCount(e.cellB) > clues[e.cellB])
+        {
+            return false;
         }
     }
     else
@@ -328,3 +128,35 @@ bool OptimizedPropagator::applyDecision(State &state, int edgeIdx, int value) co
 
     return true;
 }
+
+void OptimizedPropagator::undoDecisions(State &state, size_t trailMark) const
+{
+    while (state.getTrailSize() > trailMark)
+    {
+        int edgeIdx = state.popTrail();
+        const Edge &e = edges[edgeIdx];
+
+        if (state.getEdgeState(edgeIdx) == 1)
+        {
+            state.unlinkSegment();
+            state.decrementPointDegree(e.u);
+            state.decrementPointDegree(e.v);
+            if (e.cellA >= 0)
+                state.decrementCellEdgeCount(e.cellA);
+            if (e.cellB >= 0)
+                state.decrementCellEdgeCount(e.cellB);
+        }
+
+        state.incrementPointUndecided(e.u);
+        state.incrementPointUndecided(e.v);
+        if (e.cellA >= 0)
+            state.incrementCellUndecided(e.cellA);
+        if (e.cellB >= 0)
+            state.incrementCellUndecided(e.cellB);
+
+        state.setEdgeState(edgeIdx, 0);
+    }
+
+    // Backtracking always returns to a propagation fixpoint
+    state.clearDirty();
+}
@@ -0,0 +1,316 @@
+#include "solver/ParityEngine.h"
+#include <algorithm>
+
+namespace slitherlink
+{
+
+    ParityEngine::ParityEngine(const std::vector<std::vector<int>> &supports,
+                               const std::vector<int> &odd, size_t edgeCount)
+        : edgeWords((edgeCount + 63) / 64), supports(supports)
+    {
+        size_t rows = supports.size();
+        stride = edgeWords + (rows + 63) / 64;
+        bits.assign(rows * stride, 0);
+        rhs.assign(rows, 0);
+        pivot.assign(rows, -1);
+        pivotRow.assign(edgeCount, -1);
+        value.assign(edgeCount, 0);
+
+        for (size_t r = 0; r < rows; ++r)
+        {
+            uint64_t *w = row((int)r);
+            for (int e : supports[r])
+                w[e >> 6] ^= uint64_t(1) << (e & 63);
+            w[edgeWords + (r >> 6)] |= uint64_t(1) << (r & 63);
+            rhs[r] = (uint8_t)(odd[r] & 1);
+        }
+
+        // Gauss-Jordan: clear the earlier pivots from each row, pivot on its
+        // first remaining edge and clear that edge from every earlier row
+        for (size_t r = 0; r < rows; ++r)
+        {
+            for (size_t k = 0; k < r; ++k)
+                if (pivot[k] >= 0 && has((int)r, pivot[k]))
+                    addRow((int)r, (int)k, false);
+            int p = firstEdge((int)r);
+            if (p < 0)
+            {
+                oddEmptyRows += rhs[r];
+                continue;
+            }
+            pivot[r] = p;
+            pivotRow[p] = (int)r;
+            rank++;
+            for (size_t k = 0; k < r; ++k)
+                if (has((int)k, p))
+                    addRow((int)k, (int)r, false);
+        }
+
+        edgeRows.resize(edgeCount);
+        rowSeen.assign(rows, 0);
+        onTrail.assign(edgeCount, 0);
+        for (size_t r = 0; r < rows; ++r)
+        {
+            const uint64_t *w = row((int)r);
+            for (size_t i = 0; i < edgeWords; ++i)
+                for (uint64_t m = w[i]; m; m &= m - 1)
+                    edgeRows[i * 64 + __builtin_ctzll(m)].push_back((int)r);
+        }
+    }
+
+    int ParityEngine::firstEdge(int r) const
+    {
+        const uint64_t *w = row(r);
+        for (size_t i = 0; i < edgeWords; ++i)
+            if (w[i])
+                return (int)(i * 64 + __builtin_ctzll(w[i]));
+        return -1;
+    }
+
+    void ParityEngine::addRow(int target, int source, bool logged)
+    {
+        uint64_t *t = row(target);
+        const uint64_t *s = row(source);
+        if (!logged)
+        {
+            // Elimination in the constructor, before the row lists exist
+            for (size_t i = 0; i < stride; ++i)
+                t[i] ^= s[i];
+        }
+        else
+        {
+            size_t base = (size_t)target * stride;
+            for (size_t i = 0; i < stride; ++i)
+                if (s[i])
+                    setWord(base + i, t[i] ^ s[i]);
+        }
+        rhs[target] ^= rhs[source];
+    }
+
+    void ParityEngine::setWord(size_t pos, uint64_t word)
+    {
+        // Log the old word, and list the row under the edges it gains
+        wordLog.push_back({pos, bits[pos]});
+        size_t r = pos / stride, i = pos % stride;
+        if (i < edgeWords)
+            for (uint64_t m = word & ~bits[pos]; m; m &= m - 1)
+                edgeRows[i * 64 + __builtin_ctzll(m)].push_back((int)r);
+        bits[pos] = word;
+    }
+
+    void ParityEngine::save(int r)
+    {
+        log.push_back({r, pivot[r], rhs[r], wordLog.size()});
+    }
+
+    const std::vector<int> &ParityEngine::rowsHolding(int edge)
+    {
+        if (++seenStamp == 0)
+        {
+            std::fill(rowSeen.begin(), rowSeen.end(), 0);
+            seenStamp = 1;
+        }
+        std::vector<int> &rows = edgeRows[edge];
+        size_t kept = 0;
+        for (int r : rows)
+        {
+            if (rowSeen[r] == seenStamp || !has(r, edge))
+                continue;
+            rowSeen[r] = seenStamp;
+            rows[kept++] = r;
+        }
+        rows.resize(kept);
+        holding.assign(rows.begin(), rows.end());
+        return holding;
+    }
+
+    bool ParityEngine::absorb(int edge, int val)
+    {
+        value[edge] = (signed char)val;
+        absorbed.push_back(edge);
+        logStart.push_back(log.size());
+
+        // Substitute the value into every row holding the edge
+        uint8_t on = (val == 1);
+        size_t word = edge >> 6;
+        uint64_t bit = uint64_t(1) << (edge & 63);
+        for (int r : rowsHolding(edge))
+        {
+            save(r);
+            setWord((size_t)r * stride + word, row(r)[word] & ~bit);
+            rhs[r] ^= on;
+        }
+
+        // Only the row the edge pivoted can lose its pivot; another edge of
+        // it takes over and is cleared from the other rows
+        int pr = pivotRow[edge];
+        if (pr < 0)
+            return true;
+        pivotRow[edge] = -1;
+        int q = firstEdge(pr);
+        if (q < 0)
+        {
+            pivot[pr] = -1;
+            rank--;
+            if (rhs[pr])
+            {
+                oddEmptyRows++;
+                conflictRow = pr;
+                return false;
+            }
+            return true;
+        }
+        pivot[pr] = q;
+        pivotRow[q] = pr;
+        for (int r : rowsHolding(q))
+        {
+            if (r != pr)
+            {
+                save(r);
+                addRow(r, pr, true);
+            }
+        }
+        return true;
+    }
+
+    void ParityEngine::popAbsorbed()
+    {
+        int edge = absorbed.back();
+        size_t start = logStart.back();
+        absorbed.pop_back();
+        logStart.pop_back();
+        value[edge] = 0;
+
+        // Restore the saved rows newest first; each carries its old pivot
+        while (log.size() > start)
+        {
+            const RowUndo &undo = log.back();
+            int r = undo.row;
+            if (pivot[r] < 0 && rhs[r])
+                oddEmptyRows--;
+            if (pivot[r] >= 0 && pivotRow[pivot[r]] == r)
+            {
+                pivotRow[pivot[r]] = -1;
+                rank--;
+            }
+            while (wordLog.size() > undo.words)
+            {
+                const WordUndo &w = wordLog.back();
+                size_t word = w.pos % stride;
+                if (word < edgeWords)
+                    for (uint64_t m = w.old & ~bits[w.pos]; m; m &= m - 1)
+                        edgeRows[word * 64 + __builtin_ctzll(m)].push_back(r);
+                bits[w.pos] = w.old;
+                wordLog.pop_back();
+            }
+            rhs[r] = undo.rhs;
+            pivot[r] = undo.pivot;
+            if (pivot[r] >= 0)
+            {
+                pivotRow[pivot[r]] = r;
+                rank++;
+            }
+            else if (rhs[r])
+                oddEmptyRows++;
+            log.pop_back();
+        }
+    }
+
+    bool ParityEngine::consistent()
+    {
+        conflictRow = -1;
+        if (oddEmptyRows == 0)
+            return true;
+        for (size_t r = 0; r < rhs.size() && conflictRow < 0; ++r)
+            if (pivot[r] < 0 && rhs[r])
+                conflictRow = (int)r;
+        return false;
+    }
+
+    bool ParityEngine::sync(const State &state)
+    {
+        size_t trailSize = state.getTrailSize();
+        if (state.getTrailOrigin() != origin)
+        {
+            // Another assignment: keep the absorbed prefix the state decided
+            // alike off its trail, then absorb its other edges off the trail
+            // (the new base) and its trail in order
+            for (size_t i = 0; i < trailSize; ++i)
+                onTrail[state.getTrailAt(i)] = 1;
+            size_t keep = 0;
+            while (keep < absorbed.size() && !onTrail[absorbed[keep]] &&
+                   state.getEdgeState(absorbed[keep]) == value[absorbed[keep]])
+                ++keep;
+            while (absorbed.size() > keep)
+                popAbsorbed();
+
+            bool ok = consistent();
+            for (size_t e = 0; ok && e < value.size(); ++e)
+            {
+                char val = state.getEdgeState((int)e);
+                if (val != 0 && value[e] == 0 && !onTrail[e])
+                    ok = absorb((int)e, val);
+            }
+            for (size_t i = 0; i < trailSize; ++i)
+                onTrail[state.getTrailAt(i)] = 0;
+            // An incomplete base is not recorded, so the next sync rescans
+            origin = ok ? state.getTrailOrigin() : 0;
+            baseCount = absorbed.size();
+            if (!ok)
+                return false;
+        }
+        else
+        {
+            // Same origin: absorbed edges past the base follow the trail up
+            // to the first entry the state has since undone
+            size_t keep = baseCount;
+            while (keep < absorbed.size() && keep - baseCount < trailSize)
+            {
+                int e = state.getTrailAt(keep - baseCount);
+                if (absorbed[keep] != e || value[e] != state.getEdgeState(e))
+                    break;
+                ++keep;
+            }
+            while (absorbed.size() > keep)
+                popAbsorbed();
+            if (!consistent())
+                return false;
+        }
+
+        for (size_t i = absorbed.size() - baseCount; i < trailSize; ++i)
+        {
+            int e = state.getTrailAt(i);
+            if (!absorb(e, state.getEdgeState(e)))
+                return false;
+        }
+        return true;
+    }
+
+    void ParityEngine::units(std::vector<std::pair<int, int>> &out) const
+    {
+        out.clear();
+        for (size_t r = 0; r < rhs.size(); ++r)
+        {
+            if (pivot[r] < 0)
+                continue;
+            const uint64_t *w = row((int)r);
+            int count = 0;
+            for (size_t i = 0; i < edgeWords && count < 2; ++i)
+                count += __builtin_popcountll(w[i]);
+            if (count == 1)
+                out.push_back({pivot[r], (int)r});
+        }
+    }
+
+    void ParityEngine::explain(const State &state, int r, std::vector<int> &out) const
+    {
+        out.clear();
+        const uint64_t *origin = row(r) + edgeWords;
+        for (size_t k = 0; k < supports.size(); ++k)
+            if ((origin[k >> 6] >> (k & 63)) & 1)
+                for (int e : supports[k])
+                    if (state.getEdgeState(e) != 0)
+                        out.push_back(e);
+    }
+
+} // namespace slitherlink
@@ -0,0 +1,59 @@
+#include "solver/PathEndHeuristic.h"
+#include <utility>
+
+namespace slitherlink
+{
+
+    PathEndHeuristic::PathEndHeuristic(const std::vector<Edge> &edges,
+                                       const std::vector<std::vector<int>> &pointEdges,
+                                       LocalScore localScore)
+        : edges(edges), pointEdges(pointEdges), localScore(std::move(localScore))
+    {
+    }
+
+    int PathEndHeuristic::selectNextEdge(const State &state) const
+    {
+        int edgeCount = (int)edges.size();
+        int bestEdge = edgeCount, bestScore = 0;
+
+        if (state.getOpenSegments() > 0)
+        {
+            // Path ends are the degree-1 points
+            int bestUndecided = 5;
+            for (int p = 0; p < (int)pointEdges.size(); ++p)
+            {
+                int und = state.getPointUndecided(p);
+                if (state.getPointDegree(p) != 1 || und == 0)
+                    continue;
+                for (int i : pointEdges[p])
+                {
+                    if (state.getEdgeState(i) != 0)
+                        continue;
+                    int score = localScore(state, i);
+                    if (score > bestScore || (score == bestScore && und < bestUndecided))
+                    {
+                        bestUndecided = und;
+                        bestScore = score;
+                        bestEdge = i;
+                    }
+                }
+            }
+            if (bestEdge != edgeCount)
+                return bestEdge;
+        }
+
+        for (int i = 0; i < edgeCount; ++i)
+        {
+            if (state.getEdgeState(i) != 0)
+                continue;
+            int score = localScore(state, i);
+            if (bestEdge == edgeCount || score > bestScore)
+            {
+                bestScore = score;
+                bestEdge = i;
+            }
+        }
+        return bestEdge;
+    }
+
+} // namespace slitherlink
@@ -0,0 +1,265 @@
+#include "solver/PatternLibrary.h"
+#include <algorithm>
+#include <tuple>
+
+namespace slitherlink
+{
+
+    namespace
+    {
+        // Templates are drawn on the doubled grid: points at (even, even),
+        // cells at (odd, odd), edges in between. In "when", a digit is a
+        // clue and '-', '|' (ON) or 'x' (OFF) is an edge that must already
+        // have that value; marks only "then" has are the edges fixed
+        struct Template
+        {
+            const char *when[7];
+            const char *then[7];
+        };
+
+        const Template templates[] = {
+            // Adjacent 3s: the three parallel edges but the middle are ON,
+            // the middle line does not continue
+            {{". . .", "     ", ". . .", " 3 3 ", ". . .", "     ", ". . ."},
+             {". . .", "  x  ", ". . .", "|3 3|", ". . .", "  x  ", ". . ."}},
+            // Diagonal 3s: the far corners are ON
+            {{". . .", " 3   ", ". . .", "   3 ", ". . ."},
+             {".-. .", "|3   ", ". . .", "   3|", ". .-."}},
+            // 3 next to a 0: the shared line continues on both ends
+            {{". . .", "     ", ". . .", " 0 3 ", ". . .", "     ", ". . ."},
+             {". . .", "  |  ", ". .-.", " 0x3|", ". .-.", "  |  ", ". . ."}},
+            // 1 or 3 diagonal to a 0: its edges at the shared corner
+            {{". . .", " 0   ", ". . .", "   1 ", ". . ."},
+             {". . .", " 0   ", ". .x.", "  x1 ", ". . ."}},
+            {{". . .", " 0   ", ". . .", "   3 ", ". . ."},
+             {". . .", " 0   ", ". .-.", "  |3 ", ". . ."}},
+            // 3 or 1 in a corner of OFF edges (or of the grid)
+            {{". . .", "  x  ", ".x. .", "   3 ", ". . ."},
+             {". . .", "  x  ", ".x.-.", "  |3 ", ". . ."}},
+            {{". . .", "  x  ", ".x. .", "   1 ", ". . ."},
+             {". . .", "  x  ", ".x.x.", "  x1 ", ". . ."}},
+            // 2 in a corner whose neighbouring corners are closed on the
+            // outside: the lines leaving those corners along the side
+            {{". . . .", "  x x  ", ".x. . .", "   2   ", ".x. . .", "       ", ". . . ."},
+             {". . . .", "  x x  ", ".x. .-.", "   2   ", ".x. . .", "  |    ", ". . . ."}},
+            // A line entering a corner of a 1 or 3 uses one edge there, so
+            // the opposite corner's edges are OFF (1) or ON (3)
+            {{". . .", "  |  ", ".x. .", "   1 ", ". . ."},
+             {". . .", "  |  ", ".x. .", "   1x", ". .x."}},
+            {{". . .", "  |  ", ".x. .", "   3 ", ". . ."},
+             {". . .", "  |  ", ".x. .", "   3|", ". .-."}},
+            // A line entering a corner of a 2 leaves through the opposite one
+            {{". . . .", "  |    ", ".x. . .", "   2   ", ". . . .", "    x  ", ". . . ."},
+             {". . . .", "  |    ", ".x. . .", "   2   ", ". . .-.", "    x  ", ". . . ."}},
+        };
+
+        enum ItemKind : int8_t
+        {
+            Clue,
+            When,
+            Then
+        };
+
+        struct Item
+        {
+            int y, x;
+            int8_t kind;
+            int8_t value; ///< Clue, or edge value (1 ON, -1 OFF)
+
+            bool operator<(const Item &o) const
+            {
+                return std::tie(y, x, kind, value) < std::tie(o.y, o.x, o.kind, o.value);
+            }
+            bool operator==(const Item &o) const
+            {
+                return y == o.y && x == o.x && kind == o.kind && value == o.value;
+            }
+        };
+
+        using Variant = std::vector<Item>;
+
+        int edgeMark(char ch) { return (ch == '-' || ch == '|') ? 1 : (ch == 'x') ? -1 : 0; }
+
+        Variant parse(const Template &t)
+        {
+            Variant v;
+            for (int y = 0; y < 7 && t.when[y]; ++y)
+            {
+                for (int x = 0; t.when[y][x]; ++x)
+                {
+                    char w = t.when[y][x], th = t.then[y][x];
+                    if ((y & 1) && (x & 1))
+                    {
+                        if (w >= '0' && w <= '3')
+                            v.push_back({y, x, Clue, (int8_t)(w - '0')});
+                    }
+                    else if ((y + x) & 1)
+                    {
+                        if (edgeMark(w))
+                            v.push_back({y, x, When, (int8_t)edgeMark(w)});
+                        else if (edgeMark(th))
+                            v.push_back({y, x, Then, (int8_t)edgeMark(th)});
+                    }
+                }
+            }
+            return v;
+        }
+
+        // Rotation by k quarter turns, then an optional mirror image; the
+        // result is shifted by even amounts so points stay points
+        Variant transform(const Variant &base, int k, bool mirror)
+        {
+            Variant v = base;
+            for (Item &it : v)
+            {
+                for (int i = 0; i < k; ++i)
+                    it = {it.x, -it.y, it.kind, it.value};
+                if (mirror)
+                    it.x = -it.x;
+            }
+            int minY = 0, minX = 0;
+            for (const Item &it : v)
+            {
+                minY = std::min(minY, it.y);
+                minX = std::min(minX, it.x);
+            }
+            minY -= minY & 1;
+            minX -= minX & 1;
+            for (Item &it : v)
+            {
+                it.y -= minY;
+                it.x -= minX;
+            }
+            std::sort(v.begin(), v.end());
+            return v;
+        }
+
+        const std::vector<Variant> &builtinVariants()
+        {
+            static const std::vector<Variant> variants = []()
+            {
+                std::vector<Variant> all;
+                for (const Template &t : templates)
+                {
+                    Variant base = parse(t);
+                    for (int k = 0; k < 4; ++k)
+                        for (bool mirror : {false, true})
+                        {
+                            Variant v = transform(base, k, mirror);
+                            if (std::find(all.begin(), all.end(), v) == all.end())
+                                all.push_back(std::move(v));
+                        }
+                }
+                return all;
+            }();
+            return variants;
+        }
+    } // namespace
+
+    size_t PatternLibrary::getVariantCount()
+    {
+        return builtinVariants().size();
+    }
+
+    PatternLibrary::PatternLibrary(int rows, int cols, const std::vector<int> &clues,
+                                   const std::vector<int> &horizEdgeIndex,
+                                   const std::vector<int> &vertEdgeIndex, size_t edgeCount)
+    {
+        // Doubled coordinates to edge index, -1 outside the grid
+        auto edgeAt = [&](int y, int x)
+        {
+            if (!(y & 1) && y >= 0 && x >= 1 && y / 2 <= rows && (x - 1) / 2 < cols)
+                return horizEdgeIndex[(y / 2) * cols + (x - 1) / 2];
+            if ((y & 1) && y >= 1 && x >= 0 && (y - 1) / 2 < rows && x / 2 <= cols)
+                return vertEdgeIndex[((y - 1) / 2) * (cols + 1) + x / 2];
+            return -1;
+        };
+
+        std::vector<int8_t> fixedAtLoad(edgeCount, 0);
+        std::vector<int> watchCount(edgeCount, 0);
+        std::vector<std::pair<int, int>> when, then;
+        whenStart.push_back(0);
+        thenStart.push_back(0);
+
+        for (const Variant &v : builtinVariants())
+        {
+            int height = 0, width = 0;
+            for (const Item &it : v)
+            {
+                height = std::max(height, it.y);
+                width = std::max(width, it.x);
+            }
+            for (int r = -(height / 2 + 1); r <= rows; ++r)
+            {
+                for (int c = -(width / 2 + 1); c <= cols; ++c)
+                {
+                    when.clear();
+                    then.clear();
+                    bool matches = true;
+                    for (const Item &it : v)
+                    {
+                        int y = it.y + 2 * r, x = it.x + 2 * c;
+                        if (it.kind == Clue)
+                        {
+                            matches = y >= 1 && x >= 1 && (y - 1) / 2 < rows && (x - 1) / 2 < cols &&
+                                      clues[((y - 1) / 2) * cols + (x - 1) / 2] == it.value;
+                        }
+                        else
+                        {
+                            // A missing edge is OFF: fine as a condition or
+                            // a conclusion that says OFF, no match otherwise
+                            int e = edgeAt(y, x);
+                            if (e < 0)
+                                matches = it.value == -1;
+                            else
+                                (it.kind == When ? when : then).push_back({e, it.value});
+                        }
+                        if (!matches)
+                            break;
+                    }
+                    if (!matches || then.empty())
+                        continue;
+
+                    if (when.empty())
+                    {
+                        for (auto [e, val] : then)
+                        {
+                            if (fixedAtLoad[e] != val)
+                                loadDeductions.push_back({e, val});
+                            fixedAtLoad[e] = (int8_t)val;
+                        }
+                        continue;
+                    }
+                    for (auto [e, val] : when)
+                    {
+                        whenEdge.push_back(e);
+                        whenValue.push_back((int8_t)val);
+                        watchCount[e]++;
+                    }
+                    for (auto [e, val] : then)
+                    {
+                        thenEdge.push_back(e);
+                        thenValue.push_back((int8_t)val);
+                    }
+                    whenStart.push_back((int)whenEdge.size());
+                    thenStart.push_back((int)thenEdge.size());
+                }
+            }
+        }
+
+        watchStart.assign(edgeCount + 1, 0);
+        for (size_t e = 0; e < edgeCount; ++e)
+            watchStart[e + 1] = watchStart[e] + watchCount[e];
+        watchInstance.resize(watchStart[edgeCount]);
+        std::vector<int> fill(watchStart.begin(), watchStart.end() - 1);
+        for (size_t inst = 0; inst + 1 < whenStart.size(); ++inst)
+            for (int i = whenStart[inst]; i < whenStart[inst + 1]; ++i)
+                watchInstance[fill[whenEdge[i]]++] = (int)inst;
+    }
+
+    void PatternLibrary::explain(int instance, std::vector<int> &out) const
+    {
+        out.assign(whenEdge.begin() + whenStart[instance], whenEdge.begin() + whenStart[instance + 1]);
+    }
+
+} // namespace slitherlink
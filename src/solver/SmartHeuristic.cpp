@@ -5,11 +5,11 @@
 namespace slitherlink
 {
 
-    SmartHeuristic::SmartHeuristic(const Grid &grid,
+    SmartHeuristic::SmartHeuristic(const std::vector<int> &clues,
                                    const std::vector<Edge> &edges,
                                    const std::vector<std::vector<int>> &cellEdges,
                                    int numPoints)
-        : grid(grid), edges(edges), cellEdges(cellEdges), numPoints(numPoints)
+        : clues(clues), edges(edges), cellEdges(cellEdges), numPoints(numPoints)
     {
     }
 
@@ -35,7 +35,6 @@ namespace slitherlink
         if (cellIdx < 0)
             return 0;
 
-        const std::vector<int> &clues = grid.getClues();
         if (cellIdx >= (int)clues.size() || clues[cellIdx] < 0)
             return 0;
 
@@ -1,23 +1,96 @@
 #include "solver/Solver.h"
+#include "solver/ActivityHeuristic.h"
+#include "solver/ColoringPropagator.h"
+#include "solver/ImplicationGraph.h"
+#include "solver/LocalRuleTable.h"
+#include "solver/NogoodLearner.h"
+#include "solver/ParityEngine.h"
+#include "solver/PathEndHeuristic.h"
+#include "solver/PatternLibrary.h"
+#include "solver/SmartHeuristic.h"
+#include "solver/TranspositionTable.h"
+#include "solver/WindowPropagator.h"
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
 #include <future>
 #include <iostream>
+#include <random>
 #include <stack>
 #include <thread>
+#include <type_traits>
+#ifdef USE_TBB
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_reduce.h>
 #include <tbb/spin_mutex.h>
 #include <tbb/task_group.h>
+#endif
 namespace slitherlink
 {
 
     using namespace std;
 
-    int Solver::calculateOptimalParallelDepth()
+    // Per-thread scratch for the reachability searches: a point is marked
+    // when mark[p] == epoch, so starting a search is O(1). The bridge pass
+    // also keeps DFS numbers (index into queue), low links and its stack
+    struct ReachScratch
+    {
+        struct Frame
+        {
+            int point;
+            int parentEdge;
+            size_t next;
+        };
+
+        vector<int> mark;
+        vector<int> queue;
+        vector<int> disc;
+        vector<int> low;
+        vector<Frame> frames;
+        int epoch = 0;
+
+        void begin(int numPoints)
+        {
+            if ((int)mark.size() < numPoints || epoch == INT_MAX)
+            {
+                mark.assign(max((int)mark.size(), numPoints), 0);
+                disc.resize(mark.size());
+                low.resize(mark.size());
+                epoch = 0;
+            }
+            ++epoch;
+            queue.clear();
+        }
+    };
+    static thread_local ReachScratch reach;
+
+    // Tag each parity system and implication graph built, so per-thread
+    // copies notice a new one
+    static atomic<unsigned> parityBuilds{0};
+    static atomic<unsigned> implicationBuilds{0};
+
+    // Luby sequence 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ... (i >= 1)
+    static long long luby(long long i)
     {
-        int totalCells = grid.n * grid.m;
-        int clueCount = count_if(grid.clues.begin(), grid.clues.end(), [](int c)
+        long long size = 1;
+        while (size < i + 1)
+            size = 2 * size + 1;
+        while (size - 1 != i)
+        {
+            size = (size - 1) / 2;
+            if (i >= size)
+                i -= size;
+        }
+        return (size + 1) / 2;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    int BasicSolver<Topology, Heuristic, Propagation>::calculateOptimalParallelDepth()
+    {
+        int totalCells = topo.getRows() * topo.getCols();
+        int clueCount = count_if(grid.getClues().begin(), grid.getClues().end(), [](int c)
                                  { return c >= 0; });
         double density = (double)clueCount / totalCells;
 
@@ -33,374 +106,852 @@ namespace slitherlink
         return max(10, min(45, depth));
     }
 
-    void Solver::buildEdges()
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::buildEdges()
     {
-        int n = grid.n, m = grid.m;
-        numPoints = (n + 1) * (m + 1);
-        horizEdgeIndex.assign((n + 1) * m, -1);
-        vertEdgeIndex.assign(n * (m + 1), -1);
-        cellEdges.assign(n * m, {});
-        pointEdges.assign(numPoints, {});
-        edges.clear();
-        clueCells.clear();
-        clueCells.reserve(grid.clues.size());
-
-        auto pointId = [m](int r, int c)
-        { return r * (m + 1) + c; };
-        int idx = 0;
-
-        // Build horizontal edges
+        // The search reads adjacency through topo; the propagators and
+        // heuristics built from these vectors take it in the same order
+        int n = topo.getRows(), m = topo.getCols();
+        edges.resize(topo.edgeCount());
+        for (size_t i = 0; i < edges.size(); ++i)
+            edges[i] = topo.edge((int)i);
+        horizEdgeIndex.resize((n + 1) * m);
         for (int r = 0; r <= n; ++r)
             for (int c = 0; c < m; ++c)
-            {
-                Edge e{pointId(r, c), pointId(r, c + 1),
-                       (r > 0) ? grid.cellIndex(r - 1, c) : -1,
-                       (r < n) ? grid.cellIndex(r, c) : -1};
-                edges.push_back(e);
-                horizEdgeIndex[r * m + c] = idx;
-                if (e.cellA >= 0)
-                    cellEdges[e.cellA].push_back(idx);
-                if (e.cellB >= 0)
-                    cellEdges[e.cellB].push_back(idx);
-                pointEdges[e.u].push_back(idx);
-                pointEdges[e.v].push_back(idx);
-                idx++;
-            }
-
-        // Build vertical edges
+                horizEdgeIndex[r * m + c] = topo.horizEdge(r, c);
+        vertEdgeIndex.resize(n * (m + 1));
         for (int r = 0; r < n; ++r)
             for (int c = 0; c <= m; ++c)
-            {
-                Edge e{pointId(r, c), pointId(r + 1, c),
-                       (c > 0) ? grid.cellIndex(r, c - 1) : -1,
-                       (c < m) ? grid.cellIndex(r, c) : -1};
-                edges.push_back(e);
-                vertEdgeIndex[r * (m + 1) + c] = idx;
-                if (e.cellA >= 0)
-                    cellEdges[e.cellA].push_back(idx);
-                if (e.cellB >= 0)
-                    cellEdges[e.cellB].push_back(idx);
-                pointEdges[e.u].push_back(idx);
-                pointEdges[e.v].push_back(idx);
-                idx++;
-            }
-
-        for (size_t i = 0; i < grid.clues.size(); ++i)
-            if (grid.clues[i] >= 0)
+                vertEdgeIndex[r * (m + 1) + c] = topo.vertEdge(r, c);
+        cellEdges.resize(topo.cellCount());
+        for (int c = 0; c < topo.cellCount(); ++c)
+            cellEdges[c].assign(topo.cellEdges(c).begin(), topo.cellEdges(c).end());
+        pointEdges.resize(topo.pointCount());
+        for (int p = 0; p < topo.pointCount(); ++p)
+            pointEdges[p].assign(topo.pointEdges(p).begin(), topo.pointEdges(p).end());
+        clueCells.clear();
+        clueCells.reserve(grid.getClues().size());
+
+        for (size_t i = 0; i < grid.getClues().size(); ++i)
+            if (grid.getClues()[i] >= 0)
                 clueCells.push_back((int)i);
+
+        // Zobrist keys: [2e] for edge e ON, [2e + 1] for OFF (fixed seed, so
+        // hashes are reproducible between runs)
+        mt19937_64 keyGen(0x51e7'4e21'9b0d'c3a5ULL);
+        zobristKeys.resize(2 * topo.edgeCount());
+        for (auto &key : zobristKeys)
+            key = keyGen();
     }
 
-    State Solver::initialState() const
+    template <typename Topology, typename Heuristic, typename Propagation>
+    State BasicSolver<Topology, Heuristic, Propagation>::initialState() const
     {
         State s;
-        s.edgeState.assign(edges.size(), 0);
-        s.pointDegree.assign(numPoints, 0);
-        s.cellEdgeCount.assign(grid.clues.size(), 0);
-        s.cellUndecided.resize(cellEdges.size());
-        s.pointUndecided.resize(numPoints);
+        s.initialize(topo.edgeCount(), topo.pointCount(), topo.cellCount());
 
-        for (int i = 0; i < numPoints; ++i)
-            s.cellUndecided[i] = cellEdges[i].size();
-        for (int i = 0; i < numPoints; ++i)
-            s.pointUndecided[i] = pointEdges[i].size();
+        for (int i = 0; i < topo.cellCount(); ++i)
+            s.setCellUndecided(i, (int)topo.cellEdges(i).size());
+        for (int i = 0; i < topo.pointCount(); ++i)
+            s.setPointUndecided(i, (int)topo.pointEdges(i).size());
+        // With no ON edges only the 0 clues are satisfied
+        s.setUnsatisfiedClues((int)count_if(clueCells.begin(), clueCells.end(),
+                                            [this](int cell) { return grid.getClues()[cell] != 0; }));
 
         return s;
     }
 
-    bool Solver::applyDecision(State &s, int edgeIdx, int val) const
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::applyDecision(State &s, int edgeIdx, int val) const
     {
-        if (s.edgeState[edgeIdx] == val)
+        char cur = s.getEdgeState(edgeIdx);
+        if (cur == val)
             return true;
-        if (s.edgeState[edgeIdx] != 0)
+        if (cur != 0)
             return false;
 
-        s.edgeState[edgeIdx] = (char)val;
+        s.setEdgeState(edgeIdx, (char)val);
+        s.pushTrail(edgeIdx);
+        s.toggleHash(zobristKeys[2 * edgeIdx + (val == 1 ? 0 : 1)]);
 
-        const Edge &e = edges[edgeIdx];
+        const Edge &e = topo.edge(edgeIdx);
 
-        s.pointUndecided[e.u]--;
-        s.pointUndecided[e.v]--;
+        s.decrementPointUndecided(e.u);
+        s.decrementPointUndecided(e.v);
+        s.markPointDirty(e.u);
+        s.markPointDirty(e.v);
         if (e.cellA >= 0)
-            s.cellUndecided[e.cellA]--;
+        {
+            s.decrementCellUndecided(e.cellA);
+            if (grid.getClues()[e.cellA] >= 0)
+                s.markCellDirty(e.cellA);
+        }
         if (e.cellB >= 0)
-            s.cellUndecided[e.cellB]--;
+        {
+            s.decrementCellUndecided(e.cellB);
+            if (grid.getClues()[e.cellB] >= 0)
+                s.markCellDirty(e.cellB);
+        }
 
-        if (val == 1)
+        bool colorsAgree = !Propagation::optionalPasses || !coloring || coloring->mergeEdge(s, edgeIdx, val);
+        if (val != 1)
+            return colorsAgree;
+
+        // Update every counter before checking, so undoDecisions can reverse
+        // a rejected decision exactly like an accepted one. A closed loop is
+        // only allowed as the whole answer: no second loop, no open segment
+        s.linkSegment(e.u, e.v);
+        s.incrementPointDegree(e.u);
+        s.incrementPointDegree(e.v);
+        bool ok = colorsAgree && s.getPointDegree(e.u) <= 2 && s.getPointDegree(e.v) <= 2 &&
+                  (s.getClosedLoops() == 0 || (s.getClosedLoops() == 1 && s.getOpenSegments() == 0));
+        for (int cell : {e.cellA, e.cellB})
         {
-            int du = ++s.pointDegree[e.u];
-            int dv = ++s.pointDegree[e.v];
-            if (du > 2 || dv > 2)
-                return false;
+            if (cell < 0)
+                continue;
+            s.incrementCellEdgeCount(cell);
+            int clue = grid.getClues()[cell];
+            if (clue < 0)
+                continue;
+            int count = s.getCellEdgeCount(cell);
+            s.adjustUnsatisfiedClues((count - 1 == clue) - (count == clue));
+            if (count > clue)
+                ok = false;
+        }
+        return ok;
+    }
 
-            if (e.cellA >= 0)
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::imply(State &s, int edgeIdx, int val, NogoodLearner::ReasonKind kind, int anchor) const
+    {
+        bool ok = applyDecision(s, edgeIdx, val);
+        if (learner)
+        {
+            learner->noteImplied(s, edgeIdx, kind, anchor);
+            if (!ok)
+                learner->noteConflictAt(s, edgeIdx);
+        }
+        return ok;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::imply(State &s, int edgeIdx, int val, const vector<int> &reason) const
+    {
+        bool ok = applyDecision(s, edgeIdx, val);
+        if (learner)
+        {
+            learner->noteImpliedBy(s, edgeIdx, reason);
+            if (!ok)
+                learner->noteConflictAt(s, edgeIdx);
+        }
+        return ok;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::undoDecisions(State &s, size_t trailMark) const
+    {
+        while (s.getTrailSize() > trailMark)
+        {
+            int edgeIdx = s.popTrail();
+
+            const Edge &e = topo.edge(edgeIdx);
+            if (s.getEdgeState(edgeIdx) == 1)
             {
-                int cnt = ++s.cellEdgeCount[e.cellA];
-                if (grid.clues[e.cellA] >= 0 && cnt > grid.clues[e.cellA])
-                    return false;
+                s.unlinkSegment();
+                s.decrementPointDegree(e.u);
+                s.decrementPointDegree(e.v);
+                for (int cell : {e.cellA, e.cellB})
+                {
+                    if (cell < 0)
+                        continue;
+                    int clue = grid.getClues()[cell], count = s.getCellEdgeCount(cell);
+                    if (clue >= 0)
+                        s.adjustUnsatisfiedClues((count == clue) - (count - 1 == clue));
+                    s.decrementCellEdgeCount(cell);
+                }
             }
+
+            s.incrementPointUndecided(e.u);
+            s.incrementPointUndecided(e.v);
+            if (e.cellA >= 0)
+                s.incrementCellUndecided(e.cellA);
             if (e.cellB >= 0)
-            {
-                int cnt = ++s.cellEdgeCount[e.cellB];
-                if (grid.clues[e.cellB] >= 0 && cnt > grid.clues[e.cellB])
-                    return false;
-            }
+                s.incrementCellUndecided(e.cellB);
+
+            if (config.enableRestarts)
+                savedPhase[edgeIdx].store(s.getEdgeState(edgeIdx), memory_order_relaxed);
+            s.toggleHash(zobristKeys[2 * edgeIdx + (s.getEdgeState(edgeIdx) == 1 ? 0 : 1)]);
+            s.setEdgeState(edgeIdx, 0);
         }
-        return true;
+
+        // Backtracking always returns to a propagation fixpoint, and to a
+        // prefix of any state that passed the reachability check
+        s.clearDirty();
+        if (s.getReachSegments() >= 0 && s.getReachMark() > trailMark)
+            s.setReachMark();
+        if (s.getBridgeMark() > trailMark)
+            s.setBridgeMark(trailMark);
+        if (s.getParityMark() > trailMark)
+            s.setParityMark(trailMark);
+        if (s.getPatternMark() > trailMark)
+            s.setPatternMark(trailMark);
+        if (s.getWindowMark() > trailMark)
+            s.setWindowMark(trailMark);
+        if (s.getImplicationMark() > trailMark)
+            s.setImplicationMark(trailMark);
+        s.undoColors(trailMark);
     }
 
-    bool Solver::quickValidityCheck(const State &s) const
+    template <typename Topology, typename Heuristic, typename Propagation>
+    vector<int> BasicSolver<Topology, Heuristic, Propagation>::colorReason(const State &s, const ColoringPropagator::Relations &why) const
     {
-#ifdef USE_TBB
-        bool pointsOk = tbb::parallel_reduce(
-            tbb::blocked_range<int>(0, numPoints), true,
-            [&](const tbb::blocked_range<int> &r, bool ok) -> bool
+        // Each relation is explained by a path of decided edges between the
+        // two cells; only the learner needs it
+        vector<int> reason;
+        if (learner)
+            for (int i = 0; i < why.count; ++i)
+                learner->cellPath(s, why.pairs[i].first, why.pairs[i].second, -1, reason);
+        return reason;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::keepsConnectivity(const State &s, int edgeIdx) const
+    {
+        // An OFF edge cannot split the ON edges apart if it only cut off a
+        // point with nothing left, or if the rest of one of its cells still
+        // joins its endpoints
+        const Edge &e = topo.edge(edgeIdx);
+        if (s.getPointUndecided(e.u) + s.getPointDegree(e.u) == 0 ||
+            s.getPointUndecided(e.v) + s.getPointDegree(e.v) == 0)
+            return true;
+        for (int cell : {e.cellA, e.cellB})
+        {
+            if (cell < 0)
+                continue;
+            bool detour = true;
+            for (int other : topo.cellEdges(cell))
+                if (other != edgeIdx && s.getEdgeState(other) == -1)
+                    detour = false;
+            if (detour)
+                return true;
+        }
+
+        // Otherwise look for a short way around within a few points
+        const int limit = 24;
+        reach.begin(topo.pointCount());
+        reach.queue.push_back(e.u);
+        reach.mark[e.u] = reach.epoch;
+        for (size_t head = 0; head < reach.queue.size() && (int)reach.queue.size() < limit; ++head)
+        {
+            int p = reach.queue[head];
+            for (int eidx : topo.pointEdges(p))
             {
-                if (!ok)
-                    return false;
-                for (int i = r.begin(); i != r.end(); ++i)
+                if (s.getEdgeState(eidx) == -1)
+                    continue;
+                const Edge &next = topo.edge(eidx);
+                int q = (next.u == p) ? next.v : next.u;
+                if (q == e.v)
+                    return true;
+                if (reach.mark[q] != reach.epoch)
                 {
-                    if (s.pointDegree[i] > 2)
-                        return false;
-                    if (s.pointDegree[i] == 1 && s.pointUndecided[i] == 0)
-                        return false;
+                    reach.mark[q] = reach.epoch;
+                    reach.queue.push_back(q);
                 }
+            }
+        }
+        return false;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::quickValidityCheck(State &s) const
+    {
+        // The ON segments must still be joinable into one loop: a search
+        // over ON and undecided edges from any ON edge has to reach every
+        // segment end
+        int ends = 2 * s.getOpenSegments();
+        if (s.getClosedLoops() > 0 || ends <= 2)
+        {
+            s.setReachMark();
+            return true;
+        }
+
+        // Incremental path: since the last state that passed, no segment was
+        // started and no OFF edge split a component, so it still passes
+        if (s.getReachSegments() == s.getSegmentsStarted() && s.getReachMark() <= s.getTrailSize())
+        {
+            bool unchanged = true;
+            for (size_t pos = s.getReachMark(); pos < s.getTrailSize() && unchanged; ++pos)
+            {
+                int eidx = s.getTrailAt(pos);
+                if (s.getEdgeState(eidx) == -1 && !keepsConnectivity(s, eidx))
+                    unchanged = false;
+            }
+            if (unchanged)
+            {
+                s.setReachMark();
                 return true;
-            },
-            [](bool a, bool b)
-            { return a && b; });
-        if (!pointsOk)
-            return false;
+            }
+        }
 
-        bool cellsOk = tbb::parallel_reduce(
-            tbb::blocked_range<size_t>(0, clueCells.size()), true,
-            [&](const tbb::blocked_range<size_t> &r, bool ok) -> bool
+        int startEdge = -1;
+        for (size_t pos = s.getTrailSize(); pos-- > 0;)
+        {
+            if (s.getEdgeState(s.getTrailAt(pos)) == 1)
             {
-                if (!ok)
-                    return false;
-                for (size_t i = r.begin(); i != r.end(); ++i)
-                {
-                    int cell = clueCells[i];
-                    int clue = grid.clues[cell];
-                    if (s.cellEdgeCount[cell] > clue)
-                        return false;
-                    if (s.cellEdgeCount[cell] + s.cellUndecided[cell] < clue)
-                        return false;
-                }
+                startEdge = s.getTrailAt(pos);
+                break;
+            }
+        }
+        if (startEdge < 0)
+        {
+            // No ON edge on the trail (presolve cleared it): ON edges decided
+            // below the trail origin still hold degrees at their points
+            for (int p = 0; p < topo.pointCount() && startEdge < 0; ++p)
+                if (s.getPointDegree(p) > 0)
+                    for (int eidx : topo.pointEdges(p))
+                        if (s.getEdgeState(eidx) == 1)
+                        {
+                            startEdge = eidx;
+                            break;
+                        }
+            if (startEdge < 0)
                 return true;
-            },
-            [](bool a, bool b)
-            { return a && b; });
-        return cellsOk;
-#else
-        for (int i = 0; i < numPoints; ++i)
+        }
+
+        vector<int> &mark = reach.mark;
+        vector<int> &queue = reach.queue;
+        reach.begin(topo.pointCount());
+        int epoch = reach.epoch;
+
+        int start = topo.edge(startEdge).u;
+        queue.push_back(start);
+        mark[start] = epoch;
+        int found = (s.getPointDegree(start) == 1) ? 1 : 0;
+        for (size_t head = 0; head < queue.size() && found < ends; ++head)
         {
-            if (s.pointDegree[i] > 2)
-                return false;
-            if (s.pointDegree[i] == 1 && s.pointUndecided[i] == 0)
-                return false;
+            int p = queue[head];
+            for (int eidx : topo.pointEdges(p))
+            {
+                if (s.getEdgeState(eidx) == -1)
+                    continue;
+                const Edge &e = topo.edge(eidx);
+                int q = (e.u == p) ? e.v : e.u;
+                if (mark[q] == epoch)
+                    continue;
+                mark[q] = epoch;
+                queue.push_back(q);
+                if (s.getPointDegree(q) == 1)
+                    found++;
+            }
+        }
+        if (found >= ends)
+        {
+            s.setReachMark();
+            return true;
         }
 
-        for (int cell : clueCells)
+        if (learner)
         {
-            int clue = grid.clues[cell];
-            if (s.cellEdgeCount[cell] > clue)
-                return false;
-            if (s.cellEdgeCount[cell] + s.cellUndecided[cell] < clue)
-                return false;
+            // The OFF edges leaving the reached region separate an ON edge
+            // inside it from one outside, whatever else is decided
+            vector<int> cut(1, startEdge);
+            for (int p : queue)
+                for (int eidx : topo.pointEdges(p))
+                {
+                    const Edge &e = topo.edge(eidx);
+                    if (s.getEdgeState(eidx) == -1 && mark[(e.u == p) ? e.v : e.u] != epoch)
+                        cut.push_back(eidx);
+                }
+            for (int eidx = 0; eidx < (int)topo.edgeCount(); ++eidx)
+            {
+                if (s.getEdgeState(eidx) == 1 && mark[topo.edge(eidx).u] != epoch)
+                {
+                    cut.push_back(eidx);
+                    break;
+                }
+            }
+            learner->noteConflictEdges(cut);
         }
-        return true;
-#endif
+        return false;
     }
 
-    bool Solver::propagateConstraints(State &s) const
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::forceBridges(State &s) const
     {
-        for (int cell : clueCells)
+        // A loop crosses every cut an even number of times, so it never uses
+        // a bridge of the ON/undecided graph: undecided bridges are OFF and
+        // an ON bridge is a contradiction. Tarjan's low links find them in
+        // the components holding an OFF edge decided since the last pass;
+        // the rest of the graph has not lost an edge since then
+        size_t from = min(s.getBridgeMark(), s.getTrailSize());
+
+        reach.begin(topo.pointCount());
+        int epoch = reach.epoch;
+        vector<int> &order = reach.queue;
+        vector<ReachScratch::Frame> &frames = reach.frames;
+        vector<int> reason;
+
+        // Reason for the bridge above subtree root q: the OFF edges that
+        // leave the subtree, which leave the bridge as its only way out
+        auto cutReason = [&](int q)
         {
-            int clue = grid.clues[cell];
-            int onCount = s.cellEdgeCount[cell];
-            int undecided = s.cellUndecided[cell];
-            int maxPossible = onCount + undecided;
+            reason.clear();
+            for (size_t i = reach.disc[q]; i < order.size(); ++i)
+            {
+                int p = order[i];
+                for (int eidx : topo.pointEdges(p))
+                {
+                    const Edge &e = topo.edge(eidx);
+                    int other = (e.u == p) ? e.v : e.u;
+                    if (s.getEdgeState(eidx) == -1 &&
+                        (reach.mark[other] != epoch || reach.disc[other] < reach.disc[q]))
+                        reason.push_back(eidx);
+                }
+            }
+        };
 
-            if (onCount > clue || maxPossible < clue)
-                return false;
-        }
+        auto visit = [&](int p, int parentEdge)
+        {
+            reach.mark[p] = epoch;
+            reach.disc[p] = reach.low[p] = (int)order.size();
+            order.push_back(p);
+            frames.push_back({p, parentEdge, 0});
+        };
 
-        vector<int> cellQueue;
-        vector<int> pointQueue;
-        vector<bool> cellQueued(grid.clues.size(), false);
-        vector<bool> pointQueued(numPoints, false);
+        size_t end = s.getTrailSize();
+        for (size_t pos = from; pos < end; ++pos)
+        {
+            int offEdge = s.getTrailAt(pos);
+            if (s.getEdgeState(offEdge) != -1)
+                continue;
+            for (int root : {topo.edge(offEdge).u, topo.edge(offEdge).v})
+            {
+                if (reach.mark[root] == epoch)
+                    continue;
+                frames.clear();
+                visit(root, -1);
+                while (!frames.empty())
+                {
+                    ReachScratch::Frame &f = frames.back();
+                    int p = f.point;
+                    if (f.next < topo.pointEdges(p).size())
+                    {
+                        int eidx = topo.pointEdges(p)[f.next++];
+                        if (eidx == f.parentEdge || s.getEdgeState(eidx) == -1)
+                            continue;
+                        const Edge &e = topo.edge(eidx);
+                        int q = (e.u == p) ? e.v : e.u;
+                        if (reach.mark[q] != epoch)
+                            visit(q, eidx);
+                        else
+                            reach.low[p] = min(reach.low[p], reach.disc[q]);
+                        continue;
+                    }
 
-        cellQueue.reserve(clueCells.size());
-        pointQueue.reserve(numPoints);
+                    int bridge = f.parentEdge;
+                    frames.pop_back();
+                    if (bridge < 0)
+                        continue;
+                    int parent = frames.back().point;
+                    reach.low[parent] = min(reach.low[parent], reach.low[p]);
+                    if (reach.low[p] <= reach.disc[parent])
+                        continue;
+
+                    if (learner)
+                        cutReason(p);
+                    if (s.getEdgeState(bridge) == 1)
+                    {
+                        if (learner)
+                        {
+                            reason.push_back(bridge);
+                            learner->noteConflictEdges(reason);
+                        }
+                        return false;
+                    }
+                    if (!imply(s, bridge, -1, reason))
+                        return false;
+                }
+            }
+        }
+        s.setBridgeMark(s.getTrailSize());
+        return true;
+    }
 
-        for (int cell : clueCells)
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::forceParity(State &s) const
+    {
+        // Each thread keeps its own copy of the eliminated system and moves
+        // it along with the states it searches
+        static thread_local unique_ptr<ParityEngine> engine;
+        static thread_local unsigned engineBuild = 0;
+        static thread_local vector<pair<int, int>> units;
+        if (!engine || engineBuild != parityBuild)
+        {
+            engine = make_unique<ParityEngine>(*parity);
+            engineBuild = parityBuild;
+        }
+
+        vector<int> reason;
+        if (!engine->sync(s))
         {
-            cellQueue.push_back(cell);
-            cellQueued[cell] = true;
+            if (learner)
+            {
+                engine->explain(s, engine->getConflictRow(), reason);
+                learner->noteConflictEdges(reason);
+            }
+            return false;
         }
-        for (int i = 0; i < numPoints; ++i)
+
+        // Forced edges go through imply, so they re-enter the dirty sets
+        engine->units(units);
+        for (auto [eidx, row] : units)
         {
-            pointQueue.push_back(i);
-            pointQueued[i] = true;
+            if (s.getEdgeState(eidx) != 0)
+                continue;
+            if (learner)
+                engine->explain(s, row, reason);
+            if (!imply(s, eidx, engine->rowOdd(row) ? 1 : -1, reason))
+                return false;
         }
+        s.setParityMark(s.getTrailSize());
+        return true;
+    }
 
-        size_t cellPos = 0, pointPos = 0;
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::forceImplications(State &s) const
+    {
+        static thread_local unique_ptr<ImplicationGraph> graph;
+        static thread_local unsigned graphBuild = 0;
+        if (!graph || graphBuild != implicationBuild)
+        {
+            graph = make_unique<ImplicationGraph>(*implications);
+            graphBuild = implicationBuild;
+        }
 
-        while (cellPos < cellQueue.size() || pointPos < pointQueue.size())
+        implicationPasses.fetch_add(1, memory_order_relaxed);
+        vector<int> reason;
+        if (!graph->analyze(s))
         {
-            while (cellPos < cellQueue.size())
+            if (learner)
             {
-                int cellIdx = cellQueue[cellPos++];
-                cellQueued[cellIdx] = false;
+                graph->explainConflict(s, reason);
+                learner->noteConflictEdges(reason);
+            }
+            return false;
+        }
 
-                int clue = grid.clues[cellIdx];
-                if (clue < 0)
+        // Failed literals: their negations go through imply, so they
+        // re-enter the dirty sets and the local rules take it from there
+        const auto &fixed = graph->getForced();
+        for (size_t i = 0; i < fixed.size(); ++i)
+        {
+            auto [eidx, val] = fixed[i];
+            if (learner)
+                graph->explain(s, i, reason);
+            if (s.getEdgeState(eidx) != 0)
+            {
+                if (s.getEdgeState(eidx) == val)
                     continue;
+                if (learner)
+                {
+                    reason.push_back(eidx);
+                    learner->noteConflictEdges(reason);
+                }
+                return false;
+            }
+            if (!imply(s, eidx, val, reason))
+                return false;
+            implicationFixed.fetch_add(1, memory_order_relaxed);
+        }
+        s.setImplicationMark(s.getTrailSize());
+        return true;
+    }
 
-                int onCount = s.cellEdgeCount[cellIdx];
-                int undecided = s.cellUndecided[cellIdx];
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::matchPatterns(State &s) const
+    {
+        // Match the instances each new trail entry completes; edges they fix
+        // join the trail and are matched in turn
+        vector<int> reason;
+        auto force = [&](int eidx, int val, int instance)
+        {
+            if (learner)
+                patterns->explain(instance, reason);
+            if (s.getEdgeState(eidx) != 0)
+            {
+                if (learner)
+                {
+                    reason.push_back(eidx);
+                    learner->noteConflictEdges(reason);
+                }
+                return false;
+            }
+            return imply(s, eidx, val, reason);
+        };
+        while (s.getPatternMark() < s.getTrailSize())
+        {
+            int eidx = s.getTrailAt(s.getPatternMark());
+            s.setPatternMark(s.getPatternMark() + 1);
+            if (!patterns->match(s, eidx, force))
+                return false;
+        }
+        return true;
+    }
 
-                if (onCount + undecided == clue)
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::filterWindows(State &s) const
+    {
+        // One batch: the windows of the trail entries since the last call,
+        // each filtered once. Forced edges go back through the cell and
+        // point rules before their own windows are revisited
+        thread_local vector<int> batch;
+        thread_local vector<char> queued;
+        thread_local vector<int> reason;
+        queued.resize(windows->getWindowCount());
+        batch.clear();
+        for (size_t pos = s.getWindowMark(); pos < s.getTrailSize(); ++pos)
+        {
+            auto [first, last] = windows->windowsOf(s.getTrailAt(pos));
+            for (const int *w = first; w != last; ++w)
+                if (!queued[*w])
                 {
-                    for (int eidx : cellEdges[cellIdx])
-                    {
-                        if (s.edgeState[eidx] == 0)
-                        {
-                            if (!applyDecision(s, eidx, 1))
-                                return false;
-
-                            const Edge &e = edges[eidx];
-                            if (e.cellA >= 0 && !cellQueued[e.cellA] && grid.clues[e.cellA] >= 0)
-                            {
-                                cellQueue.push_back(e.cellA);
-                                cellQueued[e.cellA] = true;
-                            }
-                            if (e.cellB >= 0 && !cellQueued[e.cellB] && grid.clues[e.cellB] >= 0)
-                            {
-                                cellQueue.push_back(e.cellB);
-                                cellQueued[e.cellB] = true;
-                            }
-                            if (!pointQueued[e.u])
-                            {
-                                pointQueue.push_back(e.u);
-                                pointQueued[e.u] = true;
-                            }
-                            if (!pointQueued[e.v])
-                            {
-                                pointQueue.push_back(e.v);
-                                pointQueued[e.v] = true;
-                            }
-                        }
-                    }
+                    queued[*w] = 1;
+                    batch.push_back(*w);
                 }
-                else if (onCount == clue && undecided > 0)
+        }
+        s.setWindowMark(s.getTrailSize());
+
+        bool ok = true;
+        for (int w : batch)
+        {
+            queued[w] = 0;
+            if (!ok)
+                continue;
+            if (learner)
+                windows->explain(s, w, reason);
+            auto force = [&](int eidx, int val)
+            {
+                if (s.getEdgeState(eidx) != 0)
                 {
-                    for (int eidx : cellEdges[cellIdx])
+                    if (s.getEdgeState(eidx) == val)
+                        return true;
+                    if (learner)
                     {
-                        if (s.edgeState[eidx] == 0)
-                        {
-                            s.edgeState[eidx] = -1;
-                            const Edge &e = edges[eidx];
-                            s.pointUndecided[e.u]--;
-                            s.pointUndecided[e.v]--;
-                            if (e.cellA >= 0)
-                                s.cellUndecided[e.cellA]--;
-                            if (e.cellB >= 0)
-                                s.cellUndecided[e.cellB]--;
-
-                            if (!pointQueued[e.u])
-                            {
-                                pointQueue.push_back(e.u);
-                                pointQueued[e.u] = true;
-                            }
-                            if (!pointQueued[e.v])
-                            {
-                                pointQueue.push_back(e.v);
-                                pointQueued[e.v] = true;
-                            }
-                        }
+                        reason.push_back(eidx);
+                        learner->noteConflictEdges(reason);
                     }
+                    return false;
                 }
-            }
+                return imply(s, eidx, val, reason);
+            };
+            auto conflict = [&]()
+            {
+                if (learner)
+                    learner->noteConflictEdges(reason);
+            };
+            ok = windows->filter(s, w, force, conflict);
+        }
+        return ok;
+    }
 
-            while (pointPos < pointQueue.size())
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::propagateConstraints(State &s) const
+    {
+        // Only cells and points touched since the last fixpoint can yield new
+        // deductions or contradictions; applyDecision keeps them in the
+        // state's dirty sets, so the work here scales with the change. Once
+        // the local rules stall, new trail entries are matched against the
+        // clue patterns, then their k x k windows are filtered; then the
+        // bridge pass runs if the trail grew by the configured interval
+        // since the last one, then the implication graph and parity passes
+        auto colorForce = [&](int eidx, int val, const ColoringPropagator::Relations &why)
+        { return imply(s, eidx, val, colorReason(s, why)); };
+        auto colorConflict = [&](const ColoringPropagator::Relations &why)
+        {
+            if (learner)
+                learner->noteConflictEdges(colorReason(s, why));
+        };
+        // Cell and point rules are table lookups on the packed edge codes:
+        // the entry's low nibble lists the edges to force ON, the high OFF
+        auto edgeCode = [&](int eidx)
+        { return s.getEdgeCode(eidx); };
+        auto forceMask = [&](const int *list, unsigned rule, NogoodLearner::ReasonKind kind, int anchor)
+        {
+            for (; rule; rule &= rule - 1)
             {
-                int ptIdx = pointQueue[pointPos++];
-                pointQueued[ptIdx] = false;
+                int bit = __builtin_ctz(rule);
+                if (!imply(s, list[bit & 3], (bit < 4) ? 1 : -1, kind, anchor))
+                    return false;
+            }
+            return true;
+        };
+        auto bridgePassDue = [&]()
+        {
+            return config.bridgeInterval > 0 &&
+                   s.getTrailSize() >= s.getBridgeMark() + (size_t)config.bridgeInterval;
+        };
+        auto parityPassDue = [&]()
+        {
+            return parity && config.parityInterval > 0 &&
+                   s.getTrailSize() >= s.getParityMark() + (size_t)config.parityInterval;
+        };
+        auto patternsPending = [&]()
+        { return patterns && s.getPatternMark() < s.getTrailSize(); };
+        auto windowsPending = [&]()
+        { return windows && s.getWindowMark() < s.getTrailSize(); };
+        auto implicationPassDue = [&]()
+        {
+            return implications && config.implicationInterval > 0 &&
+                   s.getTrailSize() >= s.getImplicationMark() + (size_t)config.implicationInterval;
+        };
+        while (s.hasDirtyCells() || s.hasDirtyPoints() ||
+               (Propagation::optionalPasses && (patternsPending() || windowsPending() || bridgePassDue() ||
+                                                implicationPassDue() || parityPassDue())))
+        {
+            if (!s.hasDirtyCells() && !s.hasDirtyPoints())
+            {
+                bool ok = patternsPending()      ? matchPatterns(s)
+                          : windowsPending()     ? filterWindows(s)
+                          : bridgePassDue()      ? forceBridges(s)
+                          : implicationPassDue() ? forceImplications(s)
+                                                 : forceParity(s);
+                if (!ok)
+                    return false;
+                continue;
+            }
 
-                int deg = s.pointDegree[ptIdx];
-                int undecided = s.pointUndecided[ptIdx];
+            while (s.hasDirtyCells())
+            {
+                int cellIdx = s.takeDirtyCell();
+                if (Propagation::optionalPasses && coloring &&
+                    !coloring->propagateCell(s, cellIdx, colorForce, colorConflict))
+                    return false;
 
-                if (deg >= 2 || (deg == 0 && undecided == 0))
+                int clue = grid.getClues()[cellIdx];
+                if (clue < 0)
                     continue;
 
-                if (deg == 1 && undecided == 1)
+                const int *ce = topo.cellEdges(cellIdx).data();
+                uint8_t rule = LocalRules::cellRule(clue, LocalRules::key(ce, 4, edgeCode));
+                if (rule == LocalRules::CONFLICT)
                 {
-                    for (int eidx : pointEdges[ptIdx])
-                    {
-                        if (s.edgeState[eidx] == 0)
-                        {
-                            if (!applyDecision(s, eidx, 1))
-                                return false;
-
-                            const Edge &e = edges[eidx];
-                            if (e.cellA >= 0 && !cellQueued[e.cellA] && grid.clues[e.cellA] >= 0)
-                            {
-                                cellQueue.push_back(e.cellA);
-                                cellQueued[e.cellA] = true;
-                            }
-                            if (e.cellB >= 0 && !cellQueued[e.cellB] && grid.clues[e.cellB] >= 0)
-                            {
-                                cellQueue.push_back(e.cellB);
-                                cellQueued[e.cellB] = true;
-                            }
-                            int otherPt = (e.u == ptIdx) ? e.v : e.u;
-                            if (!pointQueued[otherPt])
-                            {
-                                pointQueue.push_back(otherPt);
-                                pointQueued[otherPt] = true;
-                            }
-                        }
-                    }
+                    if (learner)
+                        learner->noteConflict(s, NogoodLearner::ReasonKind::Cell, cellIdx);
+                    return false;
+                }
+                if (!forceMask(ce, rule, NogoodLearner::ReasonKind::Cell, cellIdx))
+                    return false;
+            }
+
+            while (s.hasDirtyPoints())
+            {
+                int ptIdx = s.takeDirtyPoint();
+
+                EdgeList pe = topo.pointEdges(ptIdx);
+                uint8_t rule = LocalRules::pointTable[LocalRules::key(pe.data(), (int)pe.size(), edgeCode)];
+                if (rule == LocalRules::CONFLICT)
+                {
+                    if (learner)
+                        learner->noteConflict(s, NogoodLearner::ReasonKind::Point, ptIdx);
+                    return false;
                 }
-                else if (deg == 2 && undecided > 0)
+
+                // An edge joining the two ends of this point's segment must
+                // stay OFF unless that loop would be the complete answer
+                if (s.getPointDegree(ptIdx) == 1 && s.getPointUndecided(ptIdx) > 0)
                 {
-                    for (int eidx : pointEdges[ptIdx])
+                    int closing = closingEdge(s, ptIdx);
+                    if (closing >= 0 && !loopMayClose(s, closing))
                     {
-                        if (s.edgeState[eidx] == 0)
-                        {
-                            s.edgeState[eidx] = -1;
-                            const Edge &e = edges[eidx];
-                            s.pointUndecided[e.u]--;
-                            s.pointUndecided[e.v]--;
-                            if (e.cellA >= 0)
-                                s.cellUndecided[e.cellA]--;
-                            if (e.cellB >= 0)
-                                s.cellUndecided[e.cellB]--;
-
-                            int otherPt = (e.u == ptIdx) ? e.v : e.u;
-                            if (!pointQueued[otherPt])
-                            {
-                                pointQueue.push_back(otherPt);
-                                pointQueued[otherPt] = true;
-                            }
-                        }
+                        if (!imply(s, closing, -1, NogoodLearner::ReasonKind::Loop, ptIdx))
+                            return false;
+                        continue; // re-queued by the OFF decision
                     }
                 }
+
+                if (!forceMask(pe.data(), rule, NogoodLearner::ReasonKind::Point, ptIdx))
+                    return false;
             }
         }
         return true;
     }
 
-    int Solver::selectNextEdge(const State &s) const
+    template <typename Topology, typename Heuristic, typename Propagation>
+    int BasicSolver<Topology, Heuristic, Propagation>::closingEdge(const State &s, int ptIdx) const
+    {
+        int other = s.getMate(ptIdx);
+        for (int eidx : topo.pointEdges(ptIdx))
+        {
+            if (s.getEdgeState(eidx) != 0)
+                continue;
+            const Edge &e = topo.edge(eidx);
+            if (e.u == other || e.v == other)
+                return eidx;
+        }
+        return -1;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::loopMayClose(const State &s, int edgeIdx) const
     {
-        int bestEdge = -1, bestScore = -1000;
+        // Closing ends the search for a loop: it must be the only segment
+        // and leave every clue exactly satisfied. Only the edge's own cells
+        // change, so the State's count of unsatisfied clues decides in O(1)
+        if (s.getOpenSegments() != 1 || s.getClosedLoops() != 0)
+            return false;
+        const Edge &e = topo.edge(edgeIdx);
+        int unsatisfied = s.getUnsatisfiedClues();
+        for (int cell : {e.cellA, e.cellB})
+        {
+            if (cell < 0 || grid.getClues()[cell] < 0)
+                continue;
+            int clue = grid.getClues()[cell], count = s.getCellEdgeCount(cell);
+            unsatisfied += (count == clue) - (count + 1 == clue);
+        }
+        return unsatisfied == 0;
+    }
+
+    // selectNextEdge's classes: class 0 is every edge next to a segment
+    // end (score 10000 and up, where the scan stopped), then one class per
+    // lower score, best first. Below 10000 a score is 5000 or not plus two
+    // cell terms, each one of CELL_TERMS; the table maps that triple to the
+    // rank of its sum among all such sums
+    static constexpr int CELL_TERMS[7] = {0, 98, 99, 100, 1000, 1500, 2000};
 
+    static constexpr std::array<uint8_t, 2 * 7 * 7> makeScoreClassTable()
+    {
+        std::array<int, 2 * 7 * 7> sums{};
+        for (int i = 0; i < 2 * 7 * 7; ++i)
+            sums[i] = (i / 49) * 5000 + CELL_TERMS[(i / 7) % 7] + CELL_TERMS[i % 7];
+        std::array<bool, 2 * 7 * 7> first{};
+        for (int j = 0; j < 2 * 7 * 7; ++j)
+        {
+            first[j] = true;
+            for (int k = 0; k < j; ++k)
+                first[j] = first[j] && sums[k] != sums[j];
+        }
+        std::array<uint8_t, 2 * 7 * 7> table{};
+        for (int i = 0; i < 2 * 7 * 7; ++i)
+        {
+            int rank = 1;
+            for (int j = 0; j < 2 * 7 * 7; ++j)
+                rank += first[j] && sums[j] > sums[i];
+            table[i] = (uint8_t)rank;
+        }
+        return table;
+    }
+
+    static constexpr std::array<uint8_t, 2 * 7 * 7> SCORE_CLASS_TABLE = makeScoreClassTable();
+    static_assert(SCORE_CLASS_TABLE[0] < State::SCORE_CLASSES, "the lowest class must fit State's bitmaps");
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    int BasicSolver<Topology, Heuristic, Propagation>::scoreEdge(const State &s, int edgeIdx) const
+    {
         auto scoreCell = [&](int cellIdx) -> int
         {
-            if (cellIdx < 0 || grid.clues[cellIdx] < 0)
+            if (cellIdx < 0 || grid.getClues()[cellIdx] < 0)
                 return 0;
-            int clue = grid.clues[cellIdx], cnt = s.cellEdgeCount[cellIdx], und = s.cellUndecided[cellIdx];
+            int clue = grid.getClues()[cellIdx], cnt = s.getCellEdgeCount(cellIdx), und = s.getCellUndecided(cellIdx);
             if (und == 0)
                 return 0;
             int need = clue - cnt;
@@ -409,38 +960,319 @@ namespace slitherlink
                                                                   : max(0, 100 - abs(need * 2 - und));
         };
 
-        for (int i = 0; i < (int)edges.size(); ++i)
+        const Edge &e = topo.edge(edgeIdx);
+        int degU = s.getPointDegree(e.u), degV = s.getPointDegree(e.v);
+        int undU = s.getPointUndecided(e.u), undV = s.getPointUndecided(e.v);
+
+        return ((degU == 1 || degV == 1) ? 10000 : 0) +
+               ((degU == 0 && undU == 2) || (degV == 0 && undV == 2) ? 5000 : 0) +
+               scoreCell(e.cellA) + scoreCell(e.cellB);
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    int BasicSolver<Topology, Heuristic, Propagation>::scoreClass(const State &s, int edgeIdx) const
+    {
+        // scoreEdge's terms as a class: any segment end is class 0, else
+        // the 5000 flag and each side cell's term index the class table
+        auto cellTerm = [&](int cellIdx) -> int
+        {
+            if (cellIdx < 0 || grid.getClues()[cellIdx] < 0)
+                return 0;
+            int clue = grid.getClues()[cellIdx], cnt = s.getCellEdgeCount(cellIdx), und = s.getCellUndecided(cellIdx);
+            if (und == 0)
+                return 0;
+            int need = clue - cnt;
+            return (need == und || need == 0) ? 6 : (und == 1) ? 5
+                                                : (und <= 2)   ? 4
+                                                               : max(0, 3 - abs(need * 2 - und));
+        };
+
+        const Edge &e = topo.edge(edgeIdx);
+        int degU = s.getPointDegree(e.u), degV = s.getPointDegree(e.v);
+        if (degU == 1 || degV == 1)
+            return 0;
+        int undU = s.getPointUndecided(e.u), undV = s.getPointUndecided(e.v);
+        int pair = (degU == 0 && undU == 2) || (degV == 0 && undV == 2);
+        return SCORE_CLASS_TABLE[(pair * 7 + cellTerm(e.cellA)) * 7 + cellTerm(e.cellB)];
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::refileEdges(State &s) const
+    {
+        // Only the edges of points and clue cells whose counts changed since
+        // the last choice can have changed class; decided edges leave theirs
+        auto refile = [&](int eidx)
+        {
+            int cls = (s.getEdgeState(eidx) != 0) ? -1 : scoreClass(s, eidx);
+            if (cls != s.getEdgeClass(eidx))
+                s.fileEdge(eidx, cls);
+        };
+        while (s.hasStalePoints())
+            for (int eidx : topo.pointEdges(s.takeStalePoint()))
+                refile(eidx);
+        while (s.hasStaleCells())
+        {
+            int cellIdx = s.takeStaleCell();
+            if (grid.getClues()[cellIdx] >= 0)
+                for (int eidx : topo.cellEdges(cellIdx))
+                    refile(eidx);
+        }
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    int BasicSolver<Topology, Heuristic, Propagation>::selectNextEdge(State &s) const
+    {
+        // A chosen heuristic replaces the score classes
+        if constexpr (!std::is_same_v<Heuristic, ScoreClasses>)
+            if (heuristic)
+                return heuristic->selectNextEdge(s);
+
+        // The scan's choice without the scan: the first edge from the scan
+        // start in the best class. Restarts rotate the start through the
+        // edges presolve left open so each restart breaks ties differently
+        refileEdges(s);
+        int best = s.getBestClass();
+        if (best < 0)
+            return (int)topo.edgeCount();
+        return s.firstInClass(best, openEdges[tieOffset]);
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::reportConflict(const State &s, size_t mark,
+                                                                       bool colorEngine) const
+    {
+        if constexpr (!std::is_same_v<Heuristic, ScoreClasses>)
+        {
+            Heuristic *bumped = (colorEngine && colorHeuristic) ? colorHeuristic.get() : heuristic.get();
+            if (bumped)
+                bumped->onConflict(s, mark);
+        }
+        else
+        {
+            (void)s;
+            (void)mark;
+            (void)colorEngine;
+        }
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::probeEdge(State &s, int eidx, vector<pair<int, int>> &fixes) const
+    {
+        // Each value is propagated to its fixpoint and undone, leaving the
+        // state as it was. What holds either way goes to fixes: the other
+        // value if one fails, else the edges both values force alike
+        thread_local vector<char> onValue;
+        thread_local vector<int> onEdges;
+        onValue.resize(topo.edgeCount());
+        fixes.clear();
+
+        size_t mark = s.getTrailSize();
+        bool onOk = applyDecision(s, eidx, 1) && propagateConstraints(s) && quickValidityCheck(s);
+        onEdges.clear();
+        if (onOk)
+            for (size_t pos = mark; pos < s.getTrailSize(); ++pos)
+            {
+                int e = s.getTrailAt(pos);
+                onValue[e] = (char)s.getEdgeState(e);
+                onEdges.push_back(e);
+            }
+        undoDecisions(s, mark);
+
+        bool offOk = applyDecision(s, eidx, -1) && propagateConstraints(s) && quickValidityCheck(s);
+        if (onOk && offOk)
         {
-            if (s.edgeState[i] != 0)
+            // The probed edge itself differs, so it never shows up here
+            for (size_t pos = mark; pos < s.getTrailSize(); ++pos)
+            {
+                int e = s.getTrailAt(pos);
+                if (onValue[e] != 0 && onValue[e] == s.getEdgeState(e))
+                    fixes.push_back({e, onValue[e]});
+            }
+        }
+        undoDecisions(s, mark);
+        for (int e : onEdges)
+            onValue[e] = 0;
+
+        if (onOk != offOk)
+            fixes.push_back({eidx, onOk ? 1 : -1});
+        return onOk || offOk;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::probe(State &s) const
+    {
+        // Failed-literal probing on the best-scored undecided edges. Edges
+        // fixed here are on the trail, so the caller's undo removes them
+        // with the node
+        thread_local vector<pair<int, int>> ranked;
+        thread_local vector<pair<int, int>> fixes;
+
+        int budget = probeBudget.load(memory_order_relaxed);
+        ranked.clear();
+        for (int i : openEdges)
+            if (s.getEdgeState(i) == 0)
+                ranked.push_back({-scoreEdge(s, i), i});
+        size_t count = min(ranked.size(), (size_t)budget);
+        partial_sort(ranked.begin(), ranked.begin() + count, ranked.end());
+
+        long long probes = 0, fixed = 0;
+        bool alive = true;
+        for (size_t k = 0; k < count && alive; ++k)
+        {
+            int eidx = ranked[k].second;
+            if (s.getEdgeState(eidx) != 0)
                 continue;
+            probes++;
+            if (!probeEdge(s, eidx, fixes))
+            {
+                alive = false;
+                break;
+            }
+            if (!fixes.empty() && fixes.back().first == eidx)
+                probeFailed.fetch_add(1, memory_order_relaxed);
+            for (size_t i = 0; i < fixes.size() && alive; ++i)
+            {
+                auto [e, val] = fixes[i];
+                if (s.getEdgeState(e) != 0)
+                    continue;
+                fixed++;
+                alive = applyDecision(s, e, val) && propagateConstraints(s) && quickValidityCheck(s);
+            }
+        }
 
-            const Edge &e = edges[i];
-            int degU = s.pointDegree[e.u], degV = s.pointDegree[e.v];
-            int undU = s.pointUndecided[e.u], undV = s.pointUndecided[e.v];
+        // Adapt the budget to the payoff: double it while probes keep
+        // fixing edges, halve it when they mostly come back empty
+        probeNodes.fetch_add(1, memory_order_relaxed);
+        probeCount.fetch_add(probes, memory_order_relaxed);
+        probeFixed.fetch_add(fixed, memory_order_relaxed);
+        if (probes > 0)
+        {
+            int next = (fixed * 4 >= probes) ? min(budget * 2, 64) : max(budget / 2, 2);
+            probeBudget.store(next, memory_order_relaxed);
+        }
+        return alive;
+    }
 
-            int score = ((degU == 1 || degV == 1) ? 10000 : 0) +
-                        ((degU == 0 && undU == 2) || (degV == 0 && undV == 2) ? 5000 : 0) +
-                        scoreCell(e.cellA) + scoreCell(e.cellB);
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::presolve(State &s)
+    {
+        // Full propagation from every clue cell and point, then rounds of
+        // probing every undecided edge (in parallel, each worker on its own
+        // copy of the state) until a round fixes nothing. What is left is
+        // made permanent and the model reduced to it: the search sees only
+        // the open edges and the clue cells next to one
+        auto start = chrono::steady_clock::now();
+        size_t loaded = s.getTrailSize();
+        for (int cell : clueCells)
+            s.markCellDirty(cell);
+        for (int p = 0; p < topo.pointCount(); ++p)
+            s.markPointDirty(p);
+        bool ok = propagateConstraints(s) && quickValidityCheck(s);
+        size_t propagated = s.getTrailSize();
+
+        vector<int> open;
+        vector<vector<pair<int, int>>> found;
+        int rounds = 0;
+        while (ok)
+        {
+            open.clear();
+            for (int i = 0; i < (int)topo.edgeCount(); ++i)
+                if (s.getEdgeState(i) == 0)
+                    open.push_back(i);
+            if (open.empty())
+                break;
+            rounds++;
 
-            if (score > bestScore)
+            found.assign(open.size(), {});
+            atomic<bool> dead{false};
+            auto probeRange = [&](size_t first, size_t last)
             {
-                bestScore = score;
-                bestEdge = i;
-                if (bestScore >= 10000)
-                    return bestEdge;
+                State local = s;
+                for (size_t i = first; i < last && !dead.load(memory_order_relaxed); ++i)
+                    if (!probeEdge(local, open[i], found[i]))
+                        dead.store(true, memory_order_relaxed);
+            };
+#ifdef USE_TBB
+            ensureArena();
+            arena->execute([&]()
+                           { tbb::parallel_for(tbb::blocked_range<size_t>(0, open.size()),
+                                               [&](const tbb::blocked_range<size_t> &r)
+                                               { probeRange(r.begin(), r.end()); }); });
+#else
+            probeRange(0, open.size());
+#endif
+            if (dead.load())
+            {
+                ok = false;
+                break;
             }
+
+            // Every fix holds in all solutions of the round's state, so one
+            // that meets the opposite value means there are none
+            size_t before = s.getTrailSize();
+            for (size_t i = 0; i < found.size() && ok; ++i)
+                for (auto [e, val] : found[i])
+                {
+                    if (s.getEdgeState(e) == val)
+                        continue;
+                    ok = s.getEdgeState(e) == 0 && applyDecision(s, e, val) &&
+                         propagateConstraints(s) && quickValidityCheck(s);
+                    if (!ok)
+                        break;
+                }
+            if (s.getTrailSize() == before)
+                break;
         }
-        return bestEdge >= 0 ? bestEdge : (int)edges.size();
+
+        if (!ok)
+            return false;
+        size_t undecided = topo.edgeCount() - s.getTrailSize();
+        s.clearTrail();
+        reduceToOpen(s);
+        long long us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        if (config.verbose)
+            cout << "Presolve: " << (propagated - loaded) << " edges fixed by propagation, "
+                 << (topo.edgeCount() - undecided - propagated) << " by probing (" << rounds << " rounds), "
+                 << undecided << " undecided left, " << openCells.size() << " of " << clueCells.size()
+                 << " clue cells open, " << us / 1000.0 << " ms\n";
+        return true;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::reduceToOpen(const State &s)
+    {
+        // A decided edge never changes again, and a clue cell with no
+        // undecided edge already holds its count, so neither is revisited
+        openEdges.clear();
+        for (int i = 0; i < (int)topo.edgeCount(); ++i)
+            if (s.getEdgeState(i) == 0)
+                openEdges.push_back(i);
+        openCells.clear();
+        for (int cell : clueCells)
+            if (s.getCellUndecided(cell) > 0)
+                openCells.push_back(cell);
     }
-    bool Solver::finalCheckAndStore(State &s)
+
+#ifdef USE_TBB
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::ensureArena()
+    {
+        // Created on first use, so puzzles presolve finishes never start one
+        if (!arena)
+            arena = make_unique<tbb::task_arena>(maxThreads);
+    }
+#endif
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::finalCheckAndStore(State &s)
     {
 #ifdef USE_TBB
         bool valid = tbb::parallel_reduce(
-            tbb::blocked_range<size_t>(0, clueCells.size()), true,
+            tbb::blocked_range<size_t>(0, openCells.size()), true,
             [&](const tbb::blocked_range<size_t> &r, bool v)
             {
                 for (size_t i = r.begin(); i < r.end() && v; ++i)
-                    if (s.cellEdgeCount[clueCells[i]] != grid.clues[clueCells[i]])
+                    if (s.getCellEdgeCount(openCells[i]) != grid.getClues()[openCells[i]])
                         v = false;
                 return v;
             },
@@ -449,31 +1281,31 @@ namespace slitherlink
         if (!valid)
             return false;
 #else
-        for (int cell : clueCells)
-            if (s.cellEdgeCount[cell] != grid.clues[cell])
+        for (int cell : openCells)
+            if (s.getCellEdgeCount(cell) != grid.getClues()[cell])
                 return false;
 #endif
 
-        vector<vector<int>> adj(numPoints);
+        vector<vector<int>> adj(topo.pointCount());
         int start = -1;
 
 #ifdef USE_TBB
-        tbb::parallel_for(tbb::blocked_range<int>(0, numPoints),
+        tbb::parallel_for(tbb::blocked_range<int>(0, topo.pointCount()),
                           [&](const tbb::blocked_range<int> &r)
                           {
                               for (int v = r.begin(); v < r.end(); ++v)
-                                  adj[v].reserve(s.pointDegree[v]);
+                                  adj[v].reserve(s.getPointDegree(v));
                           });
 
         tbb::spin_mutex startMutex;
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, edges.size()),
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, topo.edgeCount()),
                           [&](const tbb::blocked_range<size_t> &r)
                           {
                               for (size_t i = r.begin(); i < r.end(); ++i)
                               {
-                                  if (s.edgeState[i] == 1)
+                                  if (s.getEdgeState(i) == 1)
                                   {
-                                      const Edge &e = edges[i];
+                                      const Edge &e = topo.edge(i);
                                       adj[e.u].push_back(e.v);
                                       adj[e.v].push_back(e.u);
                                       if (start == -1)
@@ -486,13 +1318,13 @@ namespace slitherlink
                               }
                           });
 #else
-        for (int v = 0; v < numPoints; ++v)
-            adj[v].reserve(s.pointDegree[v]);
-        for (size_t i = 0; i < edges.size(); ++i)
+        for (int v = 0; v < topo.pointCount(); ++v)
+            adj[v].reserve(s.getPointDegree(v));
+        for (size_t i = 0; i < topo.edgeCount(); ++i)
         {
-            if (s.edgeState[i] == 1)
+            if (s.getEdgeState(i) == 1)
             {
-                const Edge &e = edges[i];
+                const Edge &e = topo.edge(i);
                 adj[e.u].push_back(e.v);
                 adj[e.v].push_back(e.u);
                 if (start == -1)
@@ -506,7 +1338,7 @@ namespace slitherlink
         int onEdges = 0;
 #ifdef USE_TBB
         auto result = tbb::parallel_reduce(
-            tbb::blocked_range<int>(0, numPoints),
+            tbb::blocked_range<int>(0, topo.pointCount()),
             make_pair(true, 0),
             [&](const tbb::blocked_range<int> &r, pair<bool, int> res)
             {
@@ -527,7 +1359,7 @@ namespace slitherlink
             return false;
         onEdges = result.second / 2;
 #else
-        for (int v = 0; v < numPoints; ++v)
+        for (int v = 0; v < topo.pointCount(); ++v)
         {
             int deg = adj[v].size();
             if (deg != 0 && deg != 2)
@@ -539,7 +1371,7 @@ namespace slitherlink
         if (onEdges == 0)
             return false;
 
-        vector<char> vis(numPoints, 0);
+        vector<char> vis(topo.pointCount(), 0);
         int visitedEdges = 0;
         stack<int> st;
         st.push(start);
@@ -561,7 +1393,7 @@ namespace slitherlink
 
 #ifdef USE_TBB
         bool allVisited = tbb::parallel_reduce(
-            tbb::blocked_range<int>(0, numPoints), true,
+            tbb::blocked_range<int>(0, topo.pointCount()), true,
             [&](const tbb::blocked_range<int> &r, bool v)
             {
                 for (int i = r.begin(); i < r.end() && v; ++i)
@@ -574,7 +1406,7 @@ namespace slitherlink
         if (!allVisited || visitedEdges / 2 != onEdges)
             return false;
 #else
-        for (int v = 0; v < numPoints; ++v)
+        for (int v = 0; v < topo.pointCount(); ++v)
             if (adj[v].size() == 2 && !vis[v])
                 return false;
         if (visitedEdges / 2 != onEdges)
@@ -582,7 +1414,7 @@ namespace slitherlink
 #endif
 
         vector<pair<int, int>> cycle;
-        int cols = grid.m + 1;
+        int cols = topo.getCols() + 1;
         auto coord = [cols](int id)
         { return make_pair(id / cols, id % cols); };
 
@@ -597,8 +1429,14 @@ namespace slitherlink
         cycle.push_back(coord(start));
 
         Solution sol;
-        sol.edgeState = s.edgeState;
-        sol.cyclePoints = cycle;
+        sol.setEdgeState(s.getEdgeStates());
+        sol.setCyclePoints(cycle);
+
+        // Without --all only the first finisher stores: parallel subtrees
+        // and racing engines may reach a solution at the same time
+        bool expected = false;
+        if (!findAll && !stopAfterFirst.compare_exchange_strong(expected, true, memory_order_acq_rel))
+            return false;
 
 #ifdef USE_TBB
         int solNum = ++solutionCount;
@@ -607,8 +1445,6 @@ namespace slitherlink
         cout << flush;
 
         tbbSolutions.push_back(sol);
-        if (!findAll)
-            stopAfterFirst.store(true, memory_order_relaxed);
 #else
         {
             lock_guard<mutex> lock(solMutex);
@@ -621,164 +1457,916 @@ namespace slitherlink
             cout << flush;
 
             solutions.push_back(std::move(sol));
-            if (!findAll)
-            {
-                stopAfterFirst.store(true, memory_order_relaxed);
-            }
         }
 #endif
         return true;
     }
 
-    void Solver::search(State s, int depth)
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::branch(State &s, int edgeIdx, int val, int depth)
     {
-        if (!findAll && stopAfterFirst.load(memory_order_relaxed))
-            return;
+        size_t mark = s.getTrailSize();
+        if (applyDecision(s, edgeIdx, val))
+            search(s, depth + 1, mark);
+        else
+            reportConflict(s, mark);
+        undoDecisions(s, mark);
+    }
 
-        if (!quickValidityCheck(s))
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::search(State &s, int depth, size_t mark)
+    {
+        // Decisions made here are undone by the caller (see branch), so the
+        // state is only copied where a subtree is handed to another thread
+        if (shouldStop())
             return;
+        if (config.enableRestarts &&
+            restartNodes.fetch_add(1, memory_order_relaxed) >= restartBudget)
+        {
+            restartPending.store(true, memory_order_relaxed);
+            return;
+        }
 
-        if (!propagateConstraints(s))
+        // Dirty-seeded propagation rechecks every cell and point the last
+        // decision touched, so no full-grid validity scan is needed per node.
+        // The trail from mark on is what that decision led to
+        searchNodes.fetch_add(1, memory_order_relaxed);
+        if (!propagateConstraints(s) || !quickValidityCheck(s))
+        {
+            reportConflict(s, mark);
+            return;
+        }
+        if (depth < config.probeDepth && !probe(s))
             return;
 
-        int edgeIdx = selectNextEdge(s);
-        if (edgeIdx == (int)edges.size())
+        int edgeIdx = 0;
+        LocalPatterns unit;
+        if (branchOnPatterns ? !selectPatterns(s, unit)
+                             : (edgeIdx = selectNextEdge(s)) == (int)topo.edgeCount())
         {
             finalCheckAndStore(s);
             return;
         }
+        auto descend = [&]()
+        {
+            if (branchOnPatterns)
+                expandPatterns(s, unit, depth);
+            else
+                expand(s, edgeIdx, depth);
+        };
+
+        if (!deadStates)
+        {
+            descend();
+            return;
+        }
+
+        // Another decision order may already have reached this exact edge
+        // assignment and exhausted it. A subtree is recorded dead only if it
+        // ran to completion and no solution appeared meanwhile (anywhere,
+        // which is conservative under parallel search)
+        uint64_t key = s.getHash();
+        if (deadStates->probe(key))
+            return;
+        int found = solutionCount.load(memory_order_relaxed);
+        descend();
+        if (!shouldStop() && solutionCount.load(memory_order_relaxed) == found)
+            deadStates->store(key);
+    }
 
-        const Edge &edge = edges[edgeIdx];
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::expand(State &s, int edgeIdx, int depth)
+    {
+        const Edge &edge = topo.edge(edgeIdx);
         bool canOff = true;
         bool canOn = true;
 
-        int degU = s.pointDegree[edge.u];
-        int degV = s.pointDegree[edge.v];
-        int undU = s.pointUndecided[edge.u];
-        int undV = s.pointUndecided[edge.v];
+        int degU = s.getPointDegree(edge.u);
+        int degV = s.getPointDegree(edge.v);
+        int undU = s.getPointUndecided(edge.u);
+        int undV = s.getPointUndecided(edge.v);
 
         if ((degU == 1 && undU == 1) || (degV == 1 && undV == 1))
             canOff = false;
         if (degU >= 2 || degV >= 2)
             canOn = false;
 
-        State offState;
-        if (canOff)
+        if (canOn && canOff && depth < maxParallelDepth)
+        {
+            // Only the spawned OFF subtree gets its own copy; it is propagated
+            // up front so dead branches never become tasks
+            State offState = s;
+            offState.clearTrail();
+            if (applyDecision(offState, edgeIdx, -1) && propagateConstraints(offState) &&
+                quickValidityCheck(offState))
+            {
+#ifdef USE_TBB
+                tbb::task_group g;
+                g.run([this, &offState, depth]()
+                      { search(offState, depth + 1); });
+                branch(s, edgeIdx, 1, depth);
+                g.wait();
+                return;
+#else
+                if (activeThreads.load(memory_order_relaxed) < maxThreads)
+                {
+                    activeThreads.fetch_add(1, memory_order_relaxed);
+                    auto fut = std::async(std::launch::async, [this, &offState, depth]()
+                                          {
+                                          search(offState, depth + 1);
+                                          activeThreads.fetch_sub(1, memory_order_relaxed); });
+                    branch(s, edgeIdx, 1, depth);
+                    fut.get();
+                    return;
+                }
+                search(offState, depth + 1);
+                if (shouldStop())
+                    return;
+                branch(s, edgeIdx, 1, depth);
+                return;
+#endif
+            }
+            reportConflict(offState, 0);
+            canOff = false;
+        }
+
+        // Saved phase: retry the value this edge last had before backtracking
+        int first = (config.enableRestarts && savedPhase[edgeIdx].load(memory_order_relaxed) == 1) ? 1 : -1;
+        if (first == 1 ? canOn : canOff)
+        {
+            branch(s, edgeIdx, first, depth);
+            if (shouldStop())
+                return;
+        }
+        if (first == 1 ? canOff : canOn)
+            branch(s, edgeIdx, -first, depth);
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::selectPatterns(const State &s, LocalPatterns &unit) const
+    {
+        // Legal assignments of a unit's undecided edges: a clue cell takes
+        // exactly its missing ON edges, a point ends with degree 0 or 2.
+        // The unit with the fewest goes first, ties to more edges fixed
+        static constexpr int choose[5][5] = {
+            {1, 0, 0, 0, 0}, {1, 1, 0, 0, 0}, {1, 2, 1, 0, 0}, {1, 3, 3, 1, 0}, {1, 4, 6, 4, 1}};
+        int cells = topo.cellCount();
+        int best = -1, bestCount = INT_MAX, bestFree = 0;
+        auto consider = [&](int u, int free, int count)
+        {
+            if (free > 0 && (count < bestCount || (count == bestCount && free > bestFree)))
+            {
+                best = u;
+                bestCount = count;
+                bestFree = free;
+            }
+        };
+        for (int c : openCells)
+        {
+            int free = s.getCellUndecided(c);
+            int need = grid.getClues()[c] - s.getCellEdgeCount(c);
+            consider(c, free, need < 0 || need > free ? 0 : choose[free][need]);
+        }
+        for (int p = 0; p < topo.pointCount(); ++p)
+        {
+            int free = s.getPointUndecided(p);
+            int deg = s.getPointDegree(p);
+            consider(cells + p, free, deg == 0 ? 1 + choose[free][2] : deg == 1 ? free : 1);
+        }
+        if (best < 0)
+            return false;
+
+        EdgeList list = best < cells ? topo.cellEdges(best) : topo.pointEdges(best - cells);
+        unit.edgeCount = 0;
+        int on = 0;
+        for (int e : list)
+        {
+            int val = s.getEdgeState(e);
+            on += val == 1;
+            if (val == 0)
+                unit.edges[unit.edgeCount++] = e;
+        }
+
+        // Children extending an open segment go first, then sparser ones
+        int rank[16];
+        unit.count = 0;
+        for (int mask = 0; mask < (1 << unit.edgeCount); ++mask)
+        {
+            int total = on + __builtin_popcount(mask);
+            if (best < cells ? total != grid.getClues()[best] : total != 0 && total != 2)
+                continue;
+            int extend = 0;
+            for (int k = 0; k < unit.edgeCount; ++k)
+                if (mask >> k & 1)
+                {
+                    const Edge &e = topo.edge(unit.edges[k]);
+                    extend += (s.getPointDegree(e.u) == 1) + (s.getPointDegree(e.v) == 1);
+                }
+            rank[unit.count] = __builtin_popcount(mask) - 4 * extend;
+            int i = unit.count++;
+            for (; i > 0 && rank[i - 1] > rank[i]; --i)
+            {
+                swap(rank[i - 1], rank[i]);
+                unit.masks[i] = unit.masks[i - 1];
+            }
+            unit.masks[i] = (uint8_t)mask;
+        }
+        return true;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::assignPattern(State &s, const LocalPatterns &unit, uint8_t mask) const
+    {
+        for (int k = 0; k < unit.edgeCount; ++k)
+        {
+            int val = (mask >> k & 1) ? 1 : -1;
+            int current = s.getEdgeState(unit.edges[k]);
+            if (current != 0 ? current != val : !applyDecision(s, unit.edges[k], val))
+                return false;
+        }
+        return true;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::expandPatterns(State &s, const LocalPatterns &unit, int depth)
+    {
+        // The children are disjoint and cover every legal assignment of the
+        // unit, so the search stays complete and --all counts each solution
+        // once. Near the root all but the first run as tasks on copies
+#ifdef USE_TBB
+        if (depth < maxParallelDepth && unit.count > 1)
+        {
+            vector<State> copies;
+            copies.reserve(unit.count - 1);
+            tbb::task_group g;
+            for (int c = 1; c < unit.count; ++c)
+            {
+                copies.push_back(s);
+                State &child = copies.back();
+                child.clearTrail();
+                if (assignPattern(child, unit, unit.masks[c]))
+                    g.run([this, &child, depth]()
+                          { search(child, depth + 1, 0); });
+                else
+                    reportConflict(child, 0);
+            }
+            size_t mark = s.getTrailSize();
+            if (assignPattern(s, unit, unit.masks[0]))
+                search(s, depth + 1, mark);
+            else
+                reportConflict(s, mark);
+            undoDecisions(s, mark);
+            g.wait();
+            return;
+        }
+#endif
+        for (int c = 0; c < unit.count && !shouldStop(); ++c)
+        {
+            size_t mark = s.getTrailSize();
+            if (assignPattern(s, unit, unit.masks[c]))
+                search(s, depth + 1, mark);
+            else
+                reportConflict(s, mark);
+            undoDecisions(s, mark);
+        }
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    int BasicSolver<Topology, Heuristic, Propagation>::selectColorCell(const State &s, int &differ) const
+    {
+        // Coloring a cell fixes its undecided edges to cells known to share
+        // the outside's color. The cell fixing most goes first, ties to clue
+        // cells, then to larger color sets (colored all at once)
+        int outsideParity;
+        int outside = s.findColor(s.getOutsideCell(), outsideParity);
+        int best = -1, bestKey = -1, bestFixes = 0;
+        for (int c = 0; c < topo.cellCount(); ++c)
         {
-            offState = s;
-            if (!(applyDecision(offState, edgeIdx, -1) && quickValidityCheck(offState) && propagateConstraints(offState)))
-                canOff = false;
+            int parity;
+            int root = s.findColor(c, parity);
+            if (root == outside)
+                continue;
+            int fixes = 0;
+            for (int eidx : topo.cellEdges(c))
+            {
+                const Edge &e = topo.edge(eidx);
+                int other = coloring->colorCell(s, e.cellA == c ? e.cellB : e.cellA);
+                fixes += s.getEdgeState(eidx) == 0 && s.findColor(other, parity) == outside;
+            }
+            int key = (fixes * 2 + (grid.getClues()[c] >= 0)) * 1024 + min(s.getColorSetSize(root), 1023);
+            if (key > bestKey)
+            {
+                best = c;
+                bestKey = key;
+                bestFixes = fixes;
+            }
         }
 
-        State onState;
-        if (canOn)
+        // Inside turns the fixed edges ON: tried first by a clue cell that
+        // still needs them and at least half of its undecided edges
+        differ = 0;
+        if (best >= 0 && grid.getClues()[best] >= 0)
         {
-            onState = s;
-            if (!(applyDecision(onState, edgeIdx, 1) && quickValidityCheck(onState) && propagateConstraints(onState)))
-                canOn = false;
+            int need = grid.getClues()[best] - s.getCellEdgeCount(best);
+            differ = need >= bestFixes && 2 * need >= s.getCellUndecided(best);
         }
+        return best;
+    }
 
-        if (!canOn && !canOff)
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::colorSearch(State &s, int depth, size_t mark)
+    {
+        // The search node of the color engine: a decision colors one cell
+        // like or unlike the outside, fixing up to four edges at once and
+        // keeping every parity constraint. The transposition table keys edge
+        // states only, so the run has none
+        if (shouldStop())
             return;
-        if (canOn && !canOff)
+        searchNodes.fetch_add(1, memory_order_relaxed);
+        if (!propagateConstraints(s) || !quickValidityCheck(s))
         {
-            search(std::move(onState), depth + 1);
+            reportConflict(s, mark, true);
             return;
         }
-        if (!canOn && canOff)
+        if (depth < config.probeDepth && !probe(s))
+            return;
+
+        int first;
+        int cell = selectColorCell(s, first);
+        if (cell < 0)
         {
-            search(std::move(offState), depth + 1);
+            // Every cell is colored, so propagation has fixed every edge
+            int edgeIdx = selectNextEdge(s);
+            if (edgeIdx == (int)topo.edgeCount())
+                finalCheckAndStore(s);
+            else
+                expand(s, edgeIdx, depth);
             return;
         }
 
+        int outsideCell = s.getOutsideCell();
+        auto branchColor = [&](State &st, int differ)
+        {
+            // A color decision has no trail entry, so its merge is undone
+            // through the color log
+            size_t trailMark = st.getTrailSize();
+            size_t logMark = st.getColorLogSize();
+            if (coloring->mergeCells(st, cell, outsideCell, differ))
+                colorSearch(st, depth + 1, trailMark);
+            undoDecisions(st, trailMark);
+            st.undoColorMerges(logMark);
+        };
 #ifdef USE_TBB
         if (depth < maxParallelDepth)
         {
+            State other = s;
+            other.clearTrail();
             tbb::task_group g;
-            g.run([this, off = std::move(offState), depth]()
-                  {
-                  State local = off;
-                  search(std::move(local), depth + 1); });
-            search(std::move(onState), depth + 1);
+            g.run([&branchColor, &other, first]()
+                  { branchColor(other, 1 - first); });
+            branchColor(s, first);
             g.wait();
+            return;
         }
-        else
+#endif
+        branchColor(s, first);
+        if (!shouldStop())
+            branchColor(s, 1 - first);
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::raceEngines(State &s)
+    {
+        // Both engines start from the same state; the first solution claims
+        // stopAfterFirst and stops the other. The color engine gets its own
+        // thread rather than a task, so the two run side by side even when
+        // the pool has a single worker
+        State colorState = s;
+        colorState.clearTrail();
+        auto colorRun = std::async(std::launch::async, [this, &colorState]()
+                                   { colorSearch(colorState, 0, 0); });
+        search(s, 0);
+        colorRun.get();
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::searchByDiscrepancy(State &s)
+    {
+        // Level k allows k deviations from the preferred value (LDS), or
+        // puts the deepest one at depth k - 1 (DDS, which visits each leaf
+        // once). A level that cut nothing off has searched the whole tree
+        int level = 0;
+        for (;; ++level)
         {
-            search(std::move(offState), depth + 1);
-            if (!findAll && stopAfterFirst.load(memory_order_relaxed))
-                return;
-            search(std::move(onState), depth + 1);
+            discrepancyLevel = level;
+            discrepancyCut.store(false, memory_order_relaxed);
+            discrepancySearch(s, 0, 0, level);
+            if (stopAfterFirst.load(memory_order_relaxed) || !discrepancyCut.load(memory_order_relaxed))
+                break;
+        }
+        cout << "Discrepancy: " << config.discrepancy << ", " << level + 1 << " levels\n";
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::discrepancySearch(State &s, int depth, size_t mark, int budget)
+    {
+        // A search node without the transposition table: a level leaves
+        // subtrees unfinished, so none of them can be recorded dead
+        if (shouldStop())
+            return;
+        searchNodes.fetch_add(1, memory_order_relaxed);
+        if (!propagateConstraints(s) || !quickValidityCheck(s))
+        {
+            reportConflict(s, mark);
+            return;
+        }
+        if (depth < config.probeDepth && !probe(s))
+            return;
+
+        int edgeIdx = selectNextEdge(s);
+        if (edgeIdx == (int)topo.edgeCount())
+        {
+            finalCheckAndStore(s);
+            return;
+        }
+
+        const Edge &edge = topo.edge(edgeIdx);
+        int degU = s.getPointDegree(edge.u);
+        int degV = s.getPointDegree(edge.v);
+        bool canOff = !((degU == 1 && s.getPointUndecided(edge.u) == 1) ||
+                        (degV == 1 && s.getPointUndecided(edge.v) == 1));
+        bool canOn = degU < 2 && degV < 2;
+
+        auto descend = [&](State &st, int val, int left)
+        {
+            size_t trailMark = st.getTrailSize();
+            if (applyDecision(st, edgeIdx, val))
+                discrepancySearch(st, depth + 1, trailMark, left);
+            else
+                reportConflict(st, trailMark);
+            undoDecisions(st, trailMark);
+        };
+
+        // A forced value is no deviation. Otherwise OFF is preferred, as
+        // the first child in expand
+        if (!canOn || !canOff)
+        {
+            if (canOn || canOff)
+                descend(s, canOn ? 1 : -1, budget);
+            return;
+        }
+        bool takePreferred = true, takeOther = budget > 0;
+        if (config.discrepancy == "dds")
+        {
+            takePreferred = depth != discrepancyLevel - 1;
+            takeOther = depth < discrepancyLevel;
+        }
+        if (!takeOther)
+            discrepancyCut.store(true, memory_order_relaxed);
+
+#ifdef USE_TBB
+        if (takePreferred && takeOther && config.discrepancyWaves && depth < maxParallelDepth)
+        {
+            State other = s;
+            other.clearTrail();
+            tbb::task_group g;
+            g.run([&descend, &other, budget]()
+                  { descend(other, 1, budget - 1); });
+            descend(s, -1, budget);
+            g.wait();
+            return;
         }
+#endif
+        if (takePreferred)
+            descend(s, -1, budget);
+        if (takeOther && !shouldStop())
+            descend(s, 1, budget - 1);
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::shouldStop() const
+    {
+        return (!findAll && stopAfterFirst.load(memory_order_relaxed)) ||
+               restartPending.load(memory_order_relaxed);
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::beginRestart(int restartIdx, mt19937 &rng)
+    {
+        // The first run keeps the deterministic tie order
+        restartBudget = luby(restartIdx + 1) * config.restartUnit;
+        restartNodes.store(0, memory_order_relaxed);
+        restartPending.store(false, memory_order_relaxed);
+        tieOffset = (restartIdx == 0 || openEdges.empty()) ? 0 : (int)(rng() % openEdges.size());
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::searchWithRestarts(State &s)
+    {
+        // Each run gets a node budget from the Luby sequence; the budgets
+        // grow without bound, so the search stays complete
+        mt19937 rng(config.randomSeed);
+        int restarts = 0;
+        while (true)
+        {
+            beginRestart(restarts, rng);
+#ifdef USE_TBB
+            ensureArena();
+            arena->execute([this, &s]()
+                           { search(s, 0); });
 #else
-        bool doParallel = (depth < maxParallelDepth &&
-                           activeThreads.load(memory_order_relaxed) < maxThreads);
-        if (doParallel)
+            search(s, 0);
+#endif
+            if (!restartPending.load(memory_order_relaxed) ||
+                (!findAll && stopAfterFirst.load(memory_order_relaxed)))
+                break;
+            restarts++;
+        }
+        restartPending.store(false, memory_order_relaxed);
+        cout << "Restarts: " << restarts << "\n";
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    bool BasicSolver<Topology, Heuristic, Propagation>::propagateWithNogoods(State &s)
+    {
+        // Clue/degree rules and learned nogoods feed each other until
+        // neither has anything left to force
+        auto assign = [this, &s](int edgeIdx, int val)
+        { return applyDecision(s, edgeIdx, val); };
+        do
         {
-            activeThreads.fetch_add(1, memory_order_relaxed);
-            auto fut = std::async(std::launch::async, [this, off = std::move(offState), depth]() mutable
-                                  {
-                                  search(std::move(off), depth + 1);
-                                  activeThreads.fetch_sub(1, memory_order_relaxed); });
-            search(std::move(onState), depth + 1);
-            fut.get();
+            if (!propagateConstraints(s) || !learner->propagate(s, assign))
+                return false;
+        } while (s.hasDirtyCells() || s.hasDirtyPoints());
+        return quickValidityCheck(s);
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::searchWithLearning(State &s)
+    {
+        // Sequential CDCL: each decision opens a level; a conflict is turned
+        // into a nogood and the search backjumps to the level where that
+        // nogood forces a value, instead of retrying siblings one by one
+        NogoodLearner cdcl(grid.getClues(), edges, cellEdges, pointEdges);
+        learner = &cdcl;
+
+        // With restarts the budget counts conflicts; learned nogoods survive
+        // a restart, so only the decisions are thrown away
+        mt19937 rng(config.randomSeed);
+        int restarts = 0;
+        long long restartAt = 0;
+        if (config.enableRestarts)
+        {
+            beginRestart(0, rng);
+            restartAt = restartBudget;
+        }
+
+        bool consistent = true;
+        while (findAll || !stopAfterFirst.load(memory_order_relaxed))
+        {
+            if (config.enableRestarts && consistent && cdcl.getLevel() > 0 &&
+                cdcl.getStats().conflicts >= restartAt)
+            {
+                undoDecisions(s, cdcl.levelMark(0));
+                cdcl.backjump(0);
+                beginRestart(++restarts, rng);
+                restartAt = cdcl.getStats().conflicts + restartBudget;
+            }
+
+            if (consistent)
+                consistent = propagateWithNogoods(s);
+
+            if (consistent)
+            {
+                int edgeIdx = selectNextEdge(s);
+                if (edgeIdx != (int)topo.edgeCount())
+                {
+                    int phase = (config.enableRestarts && savedPhase[edgeIdx].load(memory_order_relaxed) == 1) ? 1 : -1;
+                    cdcl.newLevel(s);
+                    consistent = applyDecision(s, edgeIdx, phase);
+                    cdcl.noteDecision(s, edgeIdx);
+                    if (!consistent)
+                        cdcl.noteConflictAt(s, edgeIdx);
+                    continue;
+                }
+                finalCheckAndStore(s);
+                if (!findAll && stopAfterFirst.load(memory_order_relaxed))
+                    break;
+            }
+
+            if (cdcl.getLevel() == 0)
+                break;
+            if (!consistent)
+                reportConflict(s, cdcl.levelMark(cdcl.getLevel() - 1));
+
+            // A complete assignment (stored or not a single loop) is blocked
+            // by its decisions; a conflict is analyzed to its first UIP
+            int assertEdge, assertValue;
+            int target = consistent ? cdcl.learnDecisionNogood(s, assertEdge, assertValue)
+                                    : cdcl.analyze(s, assertEdge, assertValue);
+            undoDecisions(s, cdcl.levelMark(target));
+            cdcl.backjump(target);
+            consistent = imply(s, assertEdge, assertValue, NogoodLearner::ReasonKind::Nogood,
+                               cdcl.lastNogood());
         }
+
+        const NogoodLearner::Stats &st = cdcl.getStats();
+        cout << "Learning: " << st.conflicts << " conflicts, " << st.learned << " nogoods, "
+             << st.propagations << " nogood propagations, " << st.backjumps << " backjumps ("
+             << st.levelsSkipped << " levels skipped)";
+        if (config.enableRestarts)
+            cout << ", " << restarts << " restarts";
+        cout << "\n";
+        learner = nullptr;
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    template <typename H>
+    std::unique_ptr<H> BasicSolver<Topology, Heuristic, Propagation>::buildHeuristic()
+    {
+        auto localScore = [this](const State &st, int edgeIdx) { return scoreEdge(st, edgeIdx); };
+        if constexpr (std::is_same_v<H, SmartHeuristic>)
+            return make_unique<SmartHeuristic>(grid.getClues(), edges, cellEdges, topo.pointCount());
+        else if constexpr (std::is_same_v<H, ActivityHeuristic>)
+            return make_unique<ActivityHeuristic>(topo.edgeCount(), config.activityDecay, localScore);
         else
+            return make_unique<PathEndHeuristic>(edges, pointEdges, localScore);
+    }
+
+    template <typename Topology, typename Heuristic, typename Propagation>
+    std::unique_ptr<Heuristic> BasicSolver<Topology, Heuristic, Propagation>::makeHeuristic()
+    {
+        // The facade picks the class config.heuristic names (none for the
+        // score classes); a static policy is that class itself
+        if constexpr (std::is_same_v<Heuristic, IHeuristic>)
         {
-            search(std::move(offState), depth + 1);
-            if (!findAll && stopAfterFirst.load(memory_order_relaxed))
-                return;
-            search(std::move(onState), depth + 1);
+            if (config.heuristic == "smart")
+                return buildHeuristic<SmartHeuristic>();
+            if (config.heuristic == "activity")
+                return buildHeuristic<ActivityHeuristic>();
+            if (config.heuristic == "path")
+                return buildHeuristic<PathEndHeuristic>();
+            return nullptr;
         }
-#endif
+        else if constexpr (std::is_same_v<Heuristic, ScoreClasses>)
+            return nullptr;
+        else
+            return buildHeuristic<Heuristic>();
     }
 
-    void Solver::run(bool allSolutions)
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::run(bool allSolutions)
     {
         findAll = allSolutions;
         stopAfterFirst.store(false, memory_order_relaxed);
         solutionCount.store(0, memory_order_relaxed);
 
         buildEdges();
-        maxParallelDepth = calculateOptimalParallelDepth();
+        maxParallelDepth = config.enableParallel ? calculateOptimalParallelDepth() : 0;
+        maxThreads = config.threads > 0 ? config.threads : max(1, (int)thread::hardware_concurrency());
 
 #ifdef USE_TBB
-        int numThreads = max(1, (int)thread::hardware_concurrency());
-        cout << "Using Intel oneAPI TBB with " << numThreads << " threads (100% CPU)\n";
+        cout << "Using Intel oneAPI TBB with " << maxThreads << " threads\n";
         cout << "Dynamic parallel depth: " << maxParallelDepth << " (optimized for "
-             << grid.n << "x" << grid.m << " puzzle)\n";
-        arena = make_unique<tbb::task_arena>(numThreads);
+             << topo.getRows() << "x" << topo.getCols() << " puzzle)\n";
+        arena.reset();
         tbbSolutions.clear();
 #endif
 
         cout << "Searching for " << (allSolutions ? "all solutions" : "first solution") << "...\n"
              << flush;
 
+        // Restarting a plain search would report solutions again, so with
+        // --all only the learning search (which blocks them) restarts
+        if (config.enableRestarts && findAll && !config.enableLearning)
+        {
+            cout << "Restarts ignored: --all without --learn\n";
+            config.enableRestarts = false;
+        }
+
+        // The color engine decides through the coloring rules. Learning and
+        // restarts decide edges, and a race only makes sense for the first
+        // solution: both engines would report every solution
+        if (config.engine != "edge" && (config.enableLearning || config.enableRestarts))
+        {
+            cout << "Engine " << config.engine << " ignored: --learn and --restarts decide edges\n";
+            config.engine = "edge";
+        }
+        if (config.engine == "race" && findAll)
+        {
+            cout << "Race ignored: --all runs the edge engine\n";
+            config.engine = "edge";
+        }
+        // Discrepancy search looks for a first solution by deviating from
+        // the binary edge order. DDS needs that order fixed between levels,
+        // which conflict activity does not keep
+        if (config.discrepancy != "off" &&
+            (findAll || config.enableLearning || config.enableRestarts ||
+             config.engine != "edge" || config.branching != "edge"))
+        {
+            cout << "Discrepancy search ignored: it needs a first-solution edge search without "
+                    "--learn, --restarts or pattern branching\n";
+            config.discrepancy = "off";
+        }
+        if (config.discrepancy == "dds" && config.heuristic == "activity")
+        {
+            cout << "DDS needs a fixed edge order: using lds with --heuristic activity\n";
+            config.discrepancy = "lds";
+        }
+        if (config.engine != "edge" && !config.enableColoring)
+        {
+            cout << "Coloring kept on for the color engine\n";
+            config.enableColoring = true;
+        }
+
+        // Inside/outside coloring shares the solver's own propagation loop
+        coloring.reset();
+        if (config.enableColoring)
+            coloring = make_unique<ColoringPropagator>(grid.getClues(), edges, cellEdges);
+
+        // Parity constraints: every line between two rows (columns) of points
+        // is crossed an even number of times, and a clue cell has clue mod 2
+        // ON edges
+        parity.reset();
+        if (config.parityInterval > 0)
+        {
+            vector<vector<int>> supports;
+            vector<int> odd;
+            for (int r = 0; r < topo.getRows(); ++r)
+            {
+                supports.emplace_back();
+                for (int c = 0; c <= topo.getCols(); ++c)
+                    supports.back().push_back(vertEdgeIndex[r * (topo.getCols() + 1) + c]);
+                odd.push_back(0);
+            }
+            for (int c = 0; c < topo.getCols(); ++c)
+            {
+                supports.emplace_back();
+                for (int r = 0; r <= topo.getRows(); ++r)
+                    supports.back().push_back(horizEdgeIndex[r * topo.getCols() + c]);
+                odd.push_back(0);
+            }
+            for (int cell : clueCells)
+            {
+                supports.push_back(cellEdges[cell]);
+                odd.push_back(grid.getClues()[cell] & 1);
+            }
+            parity = make_unique<ParityEngine>(supports, odd, topo.edgeCount());
+            parityBuild = ++parityBuilds;
+        }
+
+        implications.reset();
+        if (config.implicationInterval > 0)
+        {
+            implications = make_unique<ImplicationGraph>(grid.getClues(), cellEdges, pointEdges);
+            implicationBuild = ++implicationBuilds;
+        }
+
+        windows.reset();
+        if (config.windowSize > 0)
+            windows = make_unique<WindowPropagator>(topo.getRows(), topo.getCols(), grid.getClues(), horizEdgeIndex,
+                                                    vertEdgeIndex, pointEdges, topo.edgeCount(),
+                                                    config.windowSize);
+
+        // Edge selection: the score scan unless another heuristic is named.
+        // A race's color engine bumps its own copy, not the edge engine's
+        heuristic = makeHeuristic();
+        colorHeuristic.reset();
+        if (config.engine == "race")
+            colorHeuristic = makeHeuristic();
+
         State startState = initialState();
 
+        // Clue-only pattern matches hold in every solution; one that
+        // contradicts another (or the clue rules) means there is none
+        patterns.reset();
+        bool loadConsistent = true;
+        if (config.enablePatterns)
+        {
+            patterns = make_unique<PatternLibrary>(topo.getRows(), topo.getCols(), grid.getClues(), horizEdgeIndex,
+                                                   vertEdgeIndex, topo.edgeCount());
+            for (auto [eidx, val] : patterns->getLoadDeductions())
+                loadConsistent = applyDecision(startState, eidx, val) && loadConsistent;
+        }
+
+        branchOnPatterns = config.branching == "pattern" && !config.enableLearning;
+        if (config.branching == "pattern" && config.enableLearning)
+            cout << "Pattern branching ignored: --learn decides single edges\n";
+        searchNodes.store(0, memory_order_relaxed);
+        // Dead-subtree table (plain edge search only: learning records the
+        // same information as nogoods, color decisions are not in the key)
+        deadStates.reset();
+        if (config.ttBudgetMB > 0 && !config.enableLearning && config.engine == "edge")
+            deadStates = make_unique<TranspositionTable>(config.ttBudgetMB << 20);
+
+        tieOffset = 0;
+        savedPhase = vector<atomic<char>>(topo.edgeCount());
+        for (auto &phase : savedPhase)
+            phase.store(0, memory_order_relaxed);
+
+        // A puzzle presolve decides completely is checked without a search
+        openEdges.resize(topo.edgeCount());
+        for (int i = 0; i < (int)topo.edgeCount(); ++i)
+            openEdges[i] = i;
+        openCells = clueCells;
+        bool solvable = loadConsistent && (!config.enablePresolve || presolve(startState));
+        bool decided = solvable && selectNextEdge(startState) == (int)topo.edgeCount();
+
 #ifdef USE_TBB
-        arena->execute([this, startState]()
-                       { search(startState, 0); });
+        if (!loadConsistent)
+            cout << "Clue patterns contradict each other\n";
+        else if (!solvable)
+            cout << "Presolve found a contradiction\n";
+        else if (decided)
+            finalCheckAndStore(startState);
+        else if (config.enableLearning)
+            searchWithLearning(startState);
+        else if (config.enableRestarts)
+            searchWithRestarts(startState);
+        else
+        {
+            ensureArena();
+            arena->execute([this, &startState]()
+                           {
+                               if (config.discrepancy != "off")
+                                   searchByDiscrepancy(startState);
+                               else if (config.engine == "color")
+                                   colorSearch(startState, 0, 0);
+                               else if (config.engine == "race")
+                                   raceEngines(startState);
+                               else
+                                   search(startState, 0);
+                           });
+        }
 
         solutions.clear();
         for (const auto &sol : tbbSolutions)
             solutions.push_back(sol);
 #else
-        search(std::move(startState), 0);
+        if (!loadConsistent)
+            cout << "Clue patterns contradict each other\n";
+        else if (!solvable)
+            cout << "Presolve found a contradiction\n";
+        else if (decided)
+            finalCheckAndStore(startState);
+        else if (config.enableLearning)
+            searchWithLearning(startState);
+        else if (config.enableRestarts)
+            searchWithRestarts(startState);
+        else if (config.discrepancy != "off")
+            searchByDiscrepancy(startState);
+        else if (config.engine == "color")
+            colorSearch(startState, 0, 0);
+        else if (config.engine == "race")
+            raceEngines(startState);
+        else
+            search(startState, 0);
 #endif
+
+        if (!config.enableLearning && searchNodes.load() > 0)
+            cout << "Search: " << searchNodes.load() << " nodes ("
+                 << (branchOnPatterns ? "pattern" : "edge") << " branching, " << config.engine
+                 << " engine)\n";
+        if (deadStates)
+            cout << "Transposition table: " << deadStates->getHits() << " hits, "
+                 << deadStates->getMisses() << " misses, " << deadStates->getStores()
+                 << " dead subtrees stored (" << deadStates->getCapacity() << " slots, "
+                 << (deadStates->getBytes() >> 20) << " MB)\n";
+        if (patterns)
+            cout << "Patterns: " << PatternLibrary::getVariantCount() << " variants, "
+                 << patterns->getInstanceCount() << " search instances, "
+                 << patterns->getLoadDeductions().size() << " edges fixed at load, "
+                 << patterns->getSearchFixed() << " during search\n";
+        if (config.probeDepth > 0 && !config.enableLearning)
+            cout << "Probing: " << probeNodes.load() << " nodes, " << probeCount.load() << " probes, "
+                 << probeFailed.load() << " failed literals, " << probeFixed.load()
+                 << " edges fixed (budget now " << probeBudget.load() << ")\n";
+        if (implications)
+            cout << "Implications: " << implicationPasses.load() << " passes, "
+                 << implicationFixed.load() << " edges fixed by failed literals\n";
+        if constexpr (!std::is_same_v<Heuristic, ScoreClasses>)
+            if (auto *activity = dynamic_cast<ActivityHeuristic *>(static_cast<IHeuristic *>(heuristic.get())))
+                cout << "Activity: " << activity->getConflicts() << " conflicts bumped (decay "
+                     << config.activityDecay << ")\n";
+        if (windows)
+            cout << "Windows: " << windows->getWindowCount() << " of " << windows->getSize() << "x"
+                 << windows->getSize() << ", " << windows->getSupportCount() << " supports, "
+                 << windows->getForced() << " edges forced\n";
     }
 
-    void Solver::printSolution(const Solution &sol) const
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::printSolution(const Solution &sol) const
     {
-        int n = grid.n, m = grid.m;
+        int n = topo.getRows(), m = topo.getCols();
         auto isHorizOn = [&](int r, int c) -> bool
         {
             int idx = horizEdgeIndex[r * m + c];
-            return sol.edgeState[idx] == 1;
+            return sol.getEdgeState()[idx] == 1;
         };
         auto isVertOn = [&](int r, int c) -> bool
         {
             int idx = vertEdgeIndex[r * (m + 1) + c];
-            return sol.edgeState[idx] == 1;
+            return sol.getEdgeState()[idx] == 1;
         };
 
         for (int r = 0; r <= n; ++r)
@@ -799,7 +2387,7 @@ namespace slitherlink
             for (int c = 0; c < m; ++c)
             {
                 vline += (isVertOn(r, c) ? "|" : " ");
-                int clue = grid.clues[grid.cellIndex(r, c)];
+                int clue = grid.getClues()[grid.cellIndex(r, c)];
                 char ch = ' ';
                 if (clue >= 0)
                     ch = char('0' + clue);
@@ -810,17 +2398,18 @@ namespace slitherlink
         }
 
         cout << "Cycle (point coordinates row,col):\n";
-        for (size_t i = 0; i < sol.cyclePoints.size(); ++i)
+        for (size_t i = 0; i < sol.getCyclePoints().size(); ++i)
         {
-            auto [r, c] = sol.cyclePoints[i];
+            auto [r, c] = sol.getCyclePoints()[i];
             cout << "(" << r << "," << c << ")";
-            if (i + 1 < sol.cyclePoints.size())
+            if (i + 1 < sol.getCyclePoints().size())
                 cout << " -> ";
         }
         cout << "\n";
     }
 
-    void Solver::printSolutions() const
+    template <typename Topology, typename Heuristic, typename Propagation>
+    void BasicSolver<Topology, Heuristic, Propagation>::printSolutions() const
     {
         if (solutions.empty())
         {
@@ -830,4 +2419,27 @@ namespace slitherlink
         cout << "\n=== SUMMARY ===\n";
         cout << "Total solutions found: " << solutions.size() << "\n";
     }
+
+    template class BasicSolver<DynamicTopology>;
+    template class BasicSolver<DynamicTopology, ScoreClasses>;
+    template class BasicSolver<DynamicTopology, ScoreClasses, LocalPropagation>;
+    template class BasicSolver<DynamicTopology, SmartHeuristic>;
+    template class BasicSolver<DynamicTopology, ActivityHeuristic>;
+    template class BasicSolver<DynamicTopology, PathEndHeuristic>;
+    template class BasicSolver<FixedTopology<5, 5>, ScoreClasses>;
+    template class BasicSolver<FixedTopology<5, 5>, ScoreClasses, LocalPropagation>;
+    template class BasicSolver<FixedTopology<5, 5>, SmartHeuristic>;
+    template class BasicSolver<FixedTopology<5, 5>, ActivityHeuristic>;
+    template class BasicSolver<FixedTopology<5, 5>, PathEndHeuristic>;
+    template class BasicSolver<FixedTopology<7, 7>, ScoreClasses>;
+    template class BasicSolver<FixedTopology<7, 7>, ScoreClasses, LocalPropagation>;
+    template class BasicSolver<FixedTopology<7, 7>, SmartHeuristic>;
+    template class BasicSolver<FixedTopology<7, 7>, ActivityHeuristic>;
+    template class BasicSolver<FixedTopology<7, 7>, PathEndHeuristic>;
+    template class BasicSolver<FixedTopology<10, 10>, ScoreClasses>;
+    template class BasicSolver<FixedTopology<10, 10>, ScoreClasses, LocalPropagation>;
+    template class BasicSolver<FixedTopology<10, 10>, SmartHeuristic>;
+    template class BasicSolver<FixedTopology<10, 10>, ActivityHeuristic>;
+    template class BasicSolver<FixedTopology<10, 10>, PathEndHeuristic>;
+
 } // namespace slitherlink
@@ -79,9 +79,53 @@ bool StandardValidator::isDefinitelyUnsolvable(const State &state) const
             return true;
     }
 
+    // ON segments that can no longer reach each other
+    if (!segmentsJoinable(state))
+        return true;
+
     return false;
 }
 
+bool StandardValidator::segmentsJoinable(const State &state) const
+{
+    // Every segment end must be reachable from any ON edge over ON and
+    // undecided edges, or the segments can never form one loop
+    int ends = 2 * state.getOpenSegments();
+    if (state.getClosedLoops() > 0 || ends <= 2)
+        return true;
+
+    int numPoints = (grid.getRows() + 1) * (grid.getCols() + 1);
+    int start = -1;
+    for (int pt = 0; pt < numPoints && start < 0; ++pt)
+    {
+        if (state.getPointDegree(pt) == 1)
+            start = pt;
+    }
+
+    std::vector<char> visited(numPoints, 0);
+    std::vector<int> queue(1, start);
+    visited[start] = 1;
+    int found = 1;
+    for (size_t head = 0; head < queue.size() && found < ends; ++head)
+    {
+        int pt = queue[head];
+        for (int eidx : pointEdges[pt])
+        {
+            if (state.getEdgeState(eidx) == -1)
+                continue;
+            const Edge &e = edges[eidx];
+            int next = (e.u == pt) ? e.v : e.u;
+            if (visited[next])
+                continue;
+            visited[next] = 1;
+            queue.push_back(next);
+            if (state.getPointDegree(next) == 1)
+                found++;
+        }
+    }
+    return found >= ends;
+}
+
 bool StandardValidator::hasCycle(const State &state) const
 {
     int numPoints = (grid.getRows() + 1) * (grid.getCols() + 1);
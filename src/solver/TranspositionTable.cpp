@@ -0,0 +1,67 @@
+#include "solver/TranspositionTable.h"
+
+namespace slitherlink
+{
+
+    TranspositionTable::TranspositionTable(size_t budgetBytes)
+    {
+        size_t buckets = 1;
+        while (buckets * 2 * WAYS * sizeof(uint64_t) <= budgetBytes)
+            buckets *= 2;
+        mask = buckets - 1;
+        slots.reset(new std::atomic<uint64_t>[buckets * WAYS]);
+        clear();
+    }
+
+    bool TranspositionTable::probe(uint64_t hash) const
+    {
+        if (hash != 0)
+        {
+            const std::atomic<uint64_t> *b = bucket(hash);
+            for (size_t i = 0; i < WAYS; ++i)
+            {
+                if (b[i].load(std::memory_order_relaxed) == hash)
+                {
+                    hits.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void TranspositionTable::store(uint64_t hash)
+    {
+        if (hash == 0)
+            return;
+
+        std::atomic<uint64_t> *b = bucket(hash);
+        size_t victim = (hash >> 62) & (WAYS - 1);
+        for (size_t i = 0; i < WAYS; ++i)
+        {
+            uint64_t cur = b[i].load(std::memory_order_relaxed);
+            if (cur == hash)
+                return;
+            if (cur == 0)
+            {
+                victim = i;
+                break;
+            }
+        }
+        // A racing writer may take the same slot; losing an entry only
+        // costs a re-search, never correctness
+        b[victim].store(hash, std::memory_order_relaxed);
+        stores.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::clear()
+    {
+        for (size_t i = 0; i < getCapacity(); ++i)
+            slots[i].store(0, std::memory_order_relaxed);
+        hits.store(0, std::memory_order_relaxed);
+        misses.store(0, std::memory_order_relaxed);
+        stores.store(0, std::memory_order_relaxed);
+    }
+
+} // namespace slitherlink
@@ -0,0 +1,178 @@
+#include "solver/WindowPropagator.h"
+#include <algorithm>
+#include <map>
+
+namespace slitherlink
+{
+
+    namespace
+    {
+        // Local numbering for a k x k window: horizontal edges (i, j),
+        // i <= k, first, then vertical edges (i, j), j <= k
+        struct WindowShape
+        {
+            int k;
+            int horiz(int i, int j) const { return i * k + j; }
+            int vert(int i, int j) const { return (k + 1) * k + i * (k + 1) + j; }
+            int edgeCount() const { return 2 * k * (k + 1); }
+
+            std::vector<int> cellEdges(int i, int j) const
+            {
+                return {horiz(i, j), horiz(i + 1, j), vert(i, j), vert(i, j + 1)};
+            }
+
+            std::vector<int> pointEdges(int i, int j) const
+            {
+                std::vector<int> list;
+                if (j > 0)
+                    list.push_back(horiz(i, j - 1));
+                if (j < k)
+                    list.push_back(horiz(i, j));
+                if (i > 0)
+                    list.push_back(vert(i - 1, j));
+                if (i < k)
+                    list.push_back(vert(i, j));
+                return list;
+            }
+        };
+
+        // Depth-first enumeration over the local edges in order, pruning a
+        // clue cell or point as soon as its count cannot be met
+        struct SupportEnumerator
+        {
+            struct Limit
+            {
+                int lo, hi;     ///< Allowed ON edges; even only if closed
+                bool closed;
+                int on = 0, left = 0;
+            };
+
+            std::vector<Limit> limits;
+            std::vector<std::vector<int>> edgeLimits; ///< Per local edge
+            std::vector<uint32_t> out;
+
+            bool holds(const Limit &l) const
+            {
+                if (l.on > l.hi || l.on + l.left < l.lo)
+                    return false;
+                return !(l.closed && l.left == 0 && l.on == 1);
+            }
+
+            void run(int edge, int edgeCount, uint32_t mask)
+            {
+                if (edge == edgeCount)
+                {
+                    out.push_back(mask);
+                    return;
+                }
+                for (int value : {0, 1})
+                {
+                    bool ok = true;
+                    for (int li : edgeLimits[edge])
+                    {
+                        limits[li].left--;
+                        limits[li].on += value;
+                        ok = ok && holds(limits[li]);
+                    }
+                    if (ok)
+                        run(edge + 1, edgeCount, mask | ((uint32_t)value << edge));
+                    for (int li : edgeLimits[edge])
+                    {
+                        limits[li].left++;
+                        limits[li].on -= value;
+                    }
+                }
+            }
+        };
+    } // namespace
+
+    WindowPropagator::WindowPropagator(int rows, int cols, const std::vector<int> &clues,
+                                       const std::vector<int> &horizEdgeIndex,
+                                       const std::vector<int> &vertEdgeIndex,
+                                       const std::vector<std::vector<int>> &pointEdges,
+                                       size_t edgeCount, int size)
+        : size(std::max(1, std::min({size, MAX_SIZE, rows, cols})))
+    {
+        const int k = this->size;
+        WindowShape shape{k};
+        edgesPerWindow = shape.edgeCount();
+
+        // A window's kind: its clues, then which of its points have every
+        // edge inside it (those on the grid border can)
+        std::map<std::vector<int>, int> kinds;
+        std::vector<int> kind;
+        std::vector<int> windowCount(edgeCount, 0);
+        for (int r0 = 0; r0 + k <= rows; ++r0)
+        {
+            for (int c0 = 0; c0 + k <= cols; ++c0)
+            {
+                for (int i = 0; i <= k; ++i)
+                    for (int j = 0; j < k; ++j)
+                        windowEdge.push_back(horizEdgeIndex[(r0 + i) * cols + c0 + j]);
+                for (int i = 0; i < k; ++i)
+                    for (int j = 0; j <= k; ++j)
+                        windowEdge.push_back(vertEdgeIndex[(r0 + i) * (cols + 1) + c0 + j]);
+                for (int i = windowEdge.size() - edgesPerWindow; i < (int)windowEdge.size(); ++i)
+                    windowCount[windowEdge[i]]++;
+
+                kind.clear();
+                for (int i = 0; i < k; ++i)
+                    for (int j = 0; j < k; ++j)
+                        kind.push_back(clues[(r0 + i) * cols + c0 + j]);
+                for (int i = 0; i <= k; ++i)
+                    for (int j = 0; j <= k; ++j)
+                        kind.push_back(pointEdges[(r0 + i) * (cols + 1) + c0 + j].size() ==
+                                       shape.pointEdges(i, j).size());
+
+                auto [it, added] = kinds.emplace(kind, (int)kindSupports.size());
+                windowKind.push_back(it->second);
+                if (!added)
+                    continue;
+
+                SupportEnumerator en;
+                en.edgeLimits.resize(edgesPerWindow);
+                auto addLimit = [&](const std::vector<int> &local, int lo, int hi, bool closed)
+                {
+                    for (int e : local)
+                        en.edgeLimits[e].push_back((int)en.limits.size());
+                    en.limits.push_back({lo, hi, closed, 0, (int)local.size()});
+                };
+                for (int i = 0; i < k; ++i)
+                    for (int j = 0; j < k; ++j)
+                        if (kind[i * k + j] >= 0)
+                            addLimit(shape.cellEdges(i, j), kind[i * k + j], kind[i * k + j], false);
+                for (int i = 0; i <= k; ++i)
+                    for (int j = 0; j <= k; ++j)
+                        addLimit(shape.pointEdges(i, j), 0, 2, kind[k * k + i * (k + 1) + j]);
+                en.run(0, edgesPerWindow, 0);
+                kindSupports.push_back(std::move(en.out));
+            }
+        }
+
+        edgeWindowStart.assign(edgeCount + 1, 0);
+        for (size_t e = 0; e < edgeCount; ++e)
+            edgeWindowStart[e + 1] = edgeWindowStart[e] + windowCount[e];
+        edgeWindows.resize(edgeWindowStart[edgeCount]);
+        std::vector<int> fill(edgeWindowStart.begin(), edgeWindowStart.end() - 1);
+        for (size_t i = 0; i < windowEdge.size(); ++i)
+            edgeWindows[fill[windowEdge[i]]++] = (int)(i / edgesPerWindow);
+    }
+
+    size_t WindowPropagator::getSupportCount() const
+    {
+        size_t total = 0;
+        for (const auto &supports : kindSupports)
+            total += supports.size();
+        return total;
+    }
+
+    void WindowPropagator::explain(const State &state, int window, std::vector<int> &out) const
+    {
+        out.clear();
+        const int *we = windowEdge.data() + (size_t)window * edgesPerWindow;
+        for (int i = 0; i < edgesPerWindow; ++i)
+            if (state.getEdgeState(we[i]) != 0)
+                out.push_back(we[i]);
+    }
+
+} // namespace slitherlink
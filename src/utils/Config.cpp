@@ -1,36 +1,70 @@
 #include "utils/Config.h"
 #include <stdexcept>
-#include <algorithm>
 
 namespace slitherlink
 {
 
-    void SolverConfig::validate()
+    void SolverConfig::validate() const
     {
-        if (cpuUsagePercent < 0.0 || cpuUsagePercent > 100.0)
+        if (threads < 0)
         {
-            throw std::invalid_argument("CPU usage must be between 0 and 100");
+            throw std::invalid_argument("Number of threads cannot be negative");
         }
 
-        if (numThreads < 0)
+        if (restartUnit < 1)
         {
-            throw std::invalid_argument("Number of threads cannot be negative");
+            throw std::invalid_argument("Restart unit must be positive");
+        }
+
+        if (bridgeInterval < 0)
+        {
+            throw std::invalid_argument("Bridge interval cannot be negative");
+        }
+
+        if (parityInterval < 0)
+        {
+            throw std::invalid_argument("Parity interval cannot be negative");
         }
 
-        if (maxSolutions < 1 && maxSolutions != -1)
+        if (implicationInterval < 0)
         {
-            throw std::invalid_argument("Max solutions must be positive or -1 for unlimited");
+            throw std::invalid_argument("Implication interval cannot be negative");
         }
 
-        if (timeoutSeconds < 0.0)
+        if (probeDepth < 0)
         {
-            throw std::invalid_argument("Timeout cannot be negative");
+            throw std::invalid_argument("Probe depth cannot be negative");
         }
 
-        // Auto-correct stopAfterFirst
-        if (maxSolutions == 1)
+        if (windowSize < 0 || windowSize > 3)
         {
-            stopAfterFirst = true;
+            throw std::invalid_argument("Window size must be between 0 and 3");
+        }
+
+        if (heuristic != "score" && heuristic != "smart" && heuristic != "activity" &&
+            heuristic != "path")
+        {
+            throw std::invalid_argument("Heuristic must be score, smart, activity or path");
+        }
+
+        if (activityDecay <= 0.0 || activityDecay > 1.0)
+        {
+            throw std::invalid_argument("Activity decay must be in (0, 1]");
+        }
+
+        if (branching != "edge" && branching != "pattern")
+        {
+            throw std::invalid_argument("Branching must be edge or pattern");
+        }
+
+        if (engine != "edge" && engine != "color" && engine != "race")
+        {
+            throw std::invalid_argument("Engine must be edge, color or race");
+        }
+
+        if (discrepancy != "off" && discrepancy != "lds" && discrepancy != "dds")
+        {
+            throw std::invalid_argument("Discrepancy must be off, lds or dds");
         }
     }
 
@@ -44,37 +78,95 @@ namespace slitherlink
 
             if (arg == "--all" || arg == "-a")
             {
-                config.stopAfterFirst = false;
-                config.maxSolutions = -1;
+                config.findAll = true;
             }
-            else if (arg == "--max-solutions" && i + 1 < argc)
+            else if (arg == "--threads" && i + 1 < argc)
             {
-                config.maxSolutions = std::stoi(argv[++i]);
+                config.threads = std::stoi(argv[++i]);
             }
-            else if (arg == "--timeout" && i + 1 < argc)
+            else if (arg == "--verbose" || arg == "-v")
             {
-                config.timeoutSeconds = std::stod(argv[++i]);
+                config.verbose = true;
             }
-            else if (arg == "--threads" && i + 1 < argc)
+            else if (arg == "--no-parallel")
             {
-                config.numThreads = std::stoi(argv[++i]);
+                config.enableParallel = false;
             }
-            else if (arg == "--cpu" && i + 1 < argc)
+            else if (arg == "--learn")
             {
-                config.cpuUsagePercent = std::stod(argv[++i]);
+                config.enableLearning = true;
             }
-            else if (arg == "--verbose" || arg == "-v")
+            else if (arg == "--restarts")
             {
-                config.verbose = true;
+                config.enableRestarts = true;
             }
-            else if (arg == "--quiet" || arg == "-q")
+            else if (arg == "--restart-unit" && i + 1 < argc)
             {
-                config.printSolutions = false;
-                config.printStatistics = false;
+                config.restartUnit = std::stoi(argv[++i]);
             }
-            else if (arg == "--no-parallel")
+            else if (arg == "--seed" && i + 1 < argc)
+            {
+                config.randomSeed = (unsigned)std::stoul(argv[++i]);
+            }
+            else if (arg == "--tt-mb" && i + 1 < argc)
+            {
+                config.ttBudgetMB = std::stoul(argv[++i]);
+            }
+            else if (arg == "--no-coloring")
+            {
+                config.enableColoring = false;
+            }
+            else if (arg == "--no-presolve")
+            {
+                config.enablePresolve = false;
+            }
+            else if (arg == "--no-patterns")
+            {
+                config.enablePatterns = false;
+            }
+            else if (arg == "--bridge-interval" && i + 1 < argc)
+            {
+                config.bridgeInterval = std::stoi(argv[++i]);
+            }
+            else if (arg == "--parity-interval" && i + 1 < argc)
+            {
+                config.parityInterval = std::stoi(argv[++i]);
+            }
+            else if (arg == "--implication-interval" && i + 1 < argc)
+            {
+                config.implicationInterval = std::stoi(argv[++i]);
+            }
+            else if (arg == "--probe-depth" && i + 1 < argc)
+            {
+                config.probeDepth = std::stoi(argv[++i]);
+            }
+            else if (arg == "--window" && i + 1 < argc)
+            {
+                config.windowSize = std::stoi(argv[++i]);
+            }
+            else if (arg == "--heuristic" && i + 1 < argc)
+            {
+                config.heuristic = argv[++i];
+            }
+            else if (arg == "--activity-decay" && i + 1 < argc)
+            {
+                config.activityDecay = std::stod(argv[++i]);
+            }
+            else if (arg == "--branching" && i + 1 < argc)
+            {
+                config.branching = argv[++i];
+            }
+            else if (arg == "--engine" && i + 1 < argc)
+            {
+                config.engine = argv[++i];
+            }
+            else if (arg == "--discrepancy" && i + 1 < argc)
+            {
+                config.discrepancy = argv[++i];
+            }
+            else if (arg == "--discrepancy-waves")
             {
-                config.enableParallelization = false;
+                config.discrepancyWaves = true;
             }
         }
 
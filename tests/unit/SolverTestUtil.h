@@ -0,0 +1,68 @@
+#ifndef SLITHERLINK_SOLVER_TEST_UTIL_H
+#define SLITHERLINK_SOLVER_TEST_UTIL_H
+
+#include "core/Grid.h"
+#include "solver/Solver.h"
+#include "utils/Config.h"
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace slitherlink
+{
+    namespace test
+    {
+
+        /** @brief Path of a puzzle under puzzles/samples */
+        inline std::string samplePuzzle(const std::string &name)
+        {
+            return std::string(SLITHERLINK_PUZZLE_DIR) + "/" + name;
+        }
+
+        inline Grid loadSample(const std::string &name)
+        {
+            Grid grid;
+            EXPECT_TRUE(grid.loadFromFile(samplePuzzle(name))) << name;
+            return grid;
+        }
+
+        /**
+         * @brief Solutions the solver reports for a grid, with its progress
+         * output (every solution is printed) swallowed
+         */
+        inline size_t countSolutions(const Grid &grid, SolverConfig config)
+        {
+            Solver solver(grid, config);
+            std::ostringstream sink;
+            std::streambuf *saved = std::cout.rdbuf(sink.rdbuf());
+            solver.run(config.findAll);
+            std::cout.rdbuf(saved);
+            return solver.getSolutions().size();
+        }
+
+        inline size_t countSolutions(const std::string &name, SolverConfig config)
+        {
+            return countSolutions(loadSample(name), config);
+        }
+
+        /** @brief Samples with their solution counts, small enough to enumerate */
+        struct SampleCount
+        {
+            const char *name;
+            size_t solutions;
+        };
+
+        static const SampleCount SAMPLE_COUNTS[] = {
+            {"4x4/example4x4.txt", 92},
+            {"4x4/example4x4_hard.txt", 286},
+            {"4x4/example4x4_medium.txt", 26},
+            {"example5x5_easy.txt", 0},
+            {"example5x5_medium.txt", 32},
+            {"6x6/example6x6_medium.txt", 1344},
+        };
+
+    } // namespace test
+} // namespace slitherlink
+
+#endif // SLITHERLINK_SOLVER_TEST_UTIL_H
@@ -0,0 +1,101 @@
+#include "utils/Config.h"
+#include <gtest/gtest.h>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace slitherlink;
+
+// Parse a command line: program name, puzzle file, then the flags
+static SolverConfig parse(std::initializer_list<std::string> flags)
+{
+    std::vector<std::string> args = {"slitherlink", "puzzle.txt"};
+    args.insert(args.end(), flags);
+    std::vector<char *> argv;
+    for (std::string &arg : args)
+        argv.push_back(&arg[0]);
+    return SolverConfig::fromCommandLine((int)argv.size(), argv.data());
+}
+
+TEST(ConfigTest, DefaultsWithoutFlags)
+{
+    SolverConfig config = parse({});
+    SolverConfig defaults;
+    EXPECT_FALSE(config.findAll);
+    EXPECT_EQ(config.threads, defaults.threads);
+    EXPECT_TRUE(config.enableParallel);
+    EXPECT_EQ(config.heuristic, "score");
+    EXPECT_EQ(config.parityInterval, defaults.parityInterval);
+    EXPECT_EQ(config.discrepancy, "off");
+}
+
+TEST(ConfigTest, SearchFlags)
+{
+    EXPECT_TRUE(parse({"--all"}).findAll);
+    EXPECT_TRUE(parse({"-a"}).findAll);
+    EXPECT_EQ(parse({"--threads", "3"}).threads, 3);
+    EXPECT_TRUE(parse({"--verbose"}).verbose);
+    EXPECT_TRUE(parse({"-v"}).verbose);
+    EXPECT_FALSE(parse({"--no-parallel"}).enableParallel);
+}
+
+TEST(ConfigTest, LearningAndRestartFlags)
+{
+    SolverConfig config = parse({"--learn", "--restarts", "--restart-unit", "50", "--seed", "7"});
+    EXPECT_TRUE(config.enableLearning);
+    EXPECT_TRUE(config.enableRestarts);
+    EXPECT_EQ(config.restartUnit, 50);
+    EXPECT_EQ(config.randomSeed, 7u);
+}
+
+TEST(ConfigTest, PropagationFlags)
+{
+    SolverConfig config = parse({"--tt-mb", "64", "--no-coloring", "--no-presolve", "--no-patterns",
+                                 "--bridge-interval", "2", "--parity-interval", "0",
+                                 "--implication-interval", "8", "--probe-depth", "5", "--window", "2"});
+    EXPECT_EQ(config.ttBudgetMB, 64u);
+    EXPECT_FALSE(config.enableColoring);
+    EXPECT_FALSE(config.enablePresolve);
+    EXPECT_FALSE(config.enablePatterns);
+    EXPECT_EQ(config.bridgeInterval, 2);
+    EXPECT_EQ(config.parityInterval, 0);
+    EXPECT_EQ(config.implicationInterval, 8);
+    EXPECT_EQ(config.probeDepth, 5);
+    EXPECT_EQ(config.windowSize, 2);
+}
+
+TEST(ConfigTest, StrategyFlags)
+{
+    SolverConfig config = parse({"--heuristic", "activity", "--activity-decay", "0.5", "--branching",
+                                 "pattern", "--engine", "race", "--discrepancy", "dds",
+                                 "--discrepancy-waves"});
+    EXPECT_EQ(config.heuristic, "activity");
+    EXPECT_DOUBLE_EQ(config.activityDecay, 0.5);
+    EXPECT_EQ(config.branching, "pattern");
+    EXPECT_EQ(config.engine, "race");
+    EXPECT_EQ(config.discrepancy, "dds");
+    EXPECT_TRUE(config.discrepancyWaves);
+
+    EXPECT_EQ(parse({"--heuristic", "smart"}).heuristic, "smart");
+    EXPECT_EQ(parse({"--heuristic", "path"}).heuristic, "path");
+    EXPECT_EQ(parse({"--engine", "color"}).engine, "color");
+    EXPECT_EQ(parse({"--discrepancy", "lds"}).discrepancy, "lds");
+}
+
+TEST(ConfigTest, RejectsValuesOutOfRange)
+{
+    EXPECT_THROW(parse({"--threads", "-1"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--restart-unit", "0"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--bridge-interval", "-1"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--parity-interval", "-2"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--implication-interval", "-1"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--probe-depth", "-1"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--window", "4"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--heuristic", "random"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--activity-decay", "0"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--branching", "cell"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--engine", "sat"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--discrepancy", "ilds"}), std::invalid_argument);
+    EXPECT_THROW(parse({"--threads", "many"}), std::invalid_argument);
+}
@@ -0,0 +1,52 @@
+#include "SolverTestUtil.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace slitherlink;
+using namespace slitherlink::test;
+
+// Discrepancy search raises its level until a solution turns up or a level
+// cuts nothing off, so it finds a first solution exactly when one exists
+class DiscrepancyTest : public ::testing::TestWithParam<SampleCount>
+{
+protected:
+    static SolverConfig firstSolution(const std::string &mode)
+    {
+        // Without presolve, so the levels search the whole puzzle
+        SolverConfig config;
+        config.discrepancy = mode;
+        config.enablePresolve = false;
+        return config;
+    }
+
+    static size_t expected() { return GetParam().solutions > 0 ? 1 : 0; }
+};
+
+TEST_P(DiscrepancyTest, LdsIsComplete)
+{
+    EXPECT_EQ(countSolutions(GetParam().name, firstSolution("lds")), expected());
+}
+
+TEST_P(DiscrepancyTest, DdsIsComplete)
+{
+    EXPECT_EQ(countSolutions(GetParam().name, firstSolution("dds")), expected());
+}
+
+TEST_P(DiscrepancyTest, DdsWavesAreComplete)
+{
+    SolverConfig config = firstSolution("dds");
+    config.discrepancyWaves = true;
+    EXPECT_EQ(countSolutions(GetParam().name, config), expected());
+}
+
+INSTANTIATE_TEST_SUITE_P(Samples, DiscrepancyTest, ::testing::ValuesIn(SAMPLE_COUNTS));
+
+TEST(DiscrepancyLargerTest, FindsFirstSolutionOnHardSample)
+{
+    for (const char *mode : {"lds", "dds"})
+    {
+        SolverConfig config;
+        config.discrepancy = mode;
+        EXPECT_EQ(countSolutions("8x8/example8x8_hard.txt", config), 1u) << mode;
+    }
+}
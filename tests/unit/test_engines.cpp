@@ -0,0 +1,137 @@
+#include "SolverTestUtil.h"
+#include "factory/SolverFactory.h"
+#include "io/SolutionCollector.h"
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace slitherlink;
+using namespace slitherlink::test;
+
+// The factory's engine is Solver's search, so every sample keeps the
+// solver's solution count through ISearchEngine and SlitherlinkSolver
+class EngineTest : public ::testing::TestWithParam<SampleCount>
+{
+protected:
+    void SetUp() override { saved = std::cout.rdbuf(sink.rdbuf()); }
+    void TearDown() override { std::cout.rdbuf(saved); }
+
+    std::ostringstream sink;
+    std::streambuf *saved = nullptr;
+};
+
+TEST_P(EngineTest, FactoryEngineKeepsCount)
+{
+    SolverConfig config;
+    config.findAll = true;
+    auto engine = SolverFactory::createEngine(loadSample(GetParam().name), config);
+    EXPECT_EQ(engine->solve(true).size(), GetParam().solutions);
+    if (GetParam().solutions > 1)
+        EXPECT_GT(engine->getNodes(), 0); // several solutions take a search
+}
+
+TEST_P(EngineTest, SlitherlinkSolverCollectsEverySolution)
+{
+    auto solver = SolverFactory::createSolver(loadSample(GetParam().name), true);
+    solver->solve();
+    std::ostringstream out;
+    solver->printResults(out);
+    std::string total = "Total solutions found: " + std::to_string(GetParam().solutions) + "\n";
+    EXPECT_NE(out.str().find(total), std::string::npos) << total;
+}
+
+INSTANTIATE_TEST_SUITE_P(Samples, EngineTest, ::testing::ValuesIn(SAMPLE_COUNTS));
+
+// The factory binds the heuristic and propagation policies at compile time;
+// the search must be the one Solver runs dispatching at run time
+class StaticPolicyTest : public ::testing::TestWithParam<const char *>
+{
+protected:
+    void SetUp() override { saved = std::cout.rdbuf(sink.rdbuf()); }
+    void TearDown() override { std::cout.rdbuf(saved); }
+
+    std::ostringstream sink;
+    std::streambuf *saved = nullptr;
+};
+
+TEST_P(StaticPolicyTest, MatchesDynamicSolver)
+{
+    Grid grid = loadSample("example5x5_medium.txt");
+    SolverConfig config;
+    config.enableParallel = false; // node counts are only comparable sequentially
+    config.enablePresolve = false;
+    config.findAll = true;
+    config.heuristic = GetParam();
+    for (bool localOnly : {false, true})
+    {
+        config.enableColoring = config.enablePatterns = !localOnly;
+        config.bridgeInterval = localOnly ? 0 : 4;
+        config.parityInterval = localOnly ? 0 : 16;
+        Solver dynamic(grid, config);
+        auto bound = SolverFactory::createEngine(grid, config, false);
+        EXPECT_EQ(bound->solve(true).size(), dynamic.solve(true).size()) << localOnly;
+        EXPECT_EQ(bound->getNodes(), dynamic.getNodes()) << localOnly;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Heuristics, StaticPolicyTest, ::testing::Values("score", "smart", "activity", "path"));
+
+TEST(StaticPolicy, RejectsOtherConfigs)
+{
+    Grid grid = loadSample("example5x5_medium.txt");
+    SolverConfig config;
+    using Activity = BasicSolver<DynamicTopology, ActivityHeuristic>;
+    using Local = BasicSolver<DynamicTopology, ScoreClasses, LocalPropagation>;
+    EXPECT_THROW(Activity solver(grid, config), std::invalid_argument); // --heuristic score
+    EXPECT_THROW(Local solver(grid, config), std::invalid_argument);    // coloring and parity on
+    config.heuristic = "activity";
+    EXPECT_NO_THROW(Activity solver(grid, config));
+}
+
+// The fixed-size instantiations are the same search over constexpr tables
+// and inline state: on every sample of their size, under each heuristic,
+// they must find the same solutions in the same number of nodes as the
+// dynamic topology
+class FixedTopologyTest : public ::testing::TestWithParam<const char *>
+{
+protected:
+    void SetUp() override { saved = std::cout.rdbuf(sink.rdbuf()); }
+    void TearDown() override { std::cout.rdbuf(saved); }
+
+    std::ostringstream sink;
+    std::streambuf *saved = nullptr;
+};
+
+TEST_P(FixedTopologyTest, MatchesDynamicSolver)
+{
+    Grid grid = loadSample(GetParam());
+    SolverConfig config;
+    config.enableParallel = false; // node counts are only comparable sequentially
+    config.enablePresolve = false; // leave the work to the search
+    config.findAll = grid.getRows() == 5;
+    for (const char *heuristic : {"score", "smart", "activity", "path"})
+    {
+        config.heuristic = heuristic;
+        auto dynamic = SolverFactory::createEngine(grid, config, false);
+        auto fixed = SolverFactory::createEngine(grid, config);
+        EXPECT_EQ(fixed->solve(config.findAll).size(), dynamic->solve(config.findAll).size()) << heuristic;
+        EXPECT_EQ(fixed->getNodes(), dynamic->getNodes()) << heuristic;
+        EXPECT_GT(dynamic->getNodes(), 0) << heuristic;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Samples, FixedTopologyTest,
+                         ::testing::Values("example5x5_easy.txt", "example5x5_medium.txt", "example5x5.txt",
+                                           "example7x7.txt", "example7x7_hard.txt", "example7x7_extreme.txt",
+                                           "10x10/example10x10.txt", "10x10/example10x10_hard.txt",
+                                           "10x10/example10x10_dense.txt"));
+
+TEST(FixedTopology, RejectsOtherSizes)
+{
+    Grid grid = loadSample("6x6/example6x6_medium.txt");
+    using Fixed5x5 = BasicSolver<FixedTopology<5, 5>, ScoreClasses>;
+    EXPECT_THROW(Fixed5x5 solver(grid), std::invalid_argument);
+    EXPECT_NO_THROW(SolverFactory::createEngine(grid)); // falls back to DynamicTopology
+}
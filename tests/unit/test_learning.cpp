@@ -0,0 +1,56 @@
+#include "SolverTestUtil.h"
+#include <gtest/gtest.h>
+
+using namespace slitherlink;
+using namespace slitherlink::test;
+
+// Learned nogoods and restarts only prune or reorder the search: every
+// sample keeps the solution count of the plain search
+class LearningTest : public ::testing::TestWithParam<SampleCount>
+{
+protected:
+    static SolverConfig allSolutions()
+    {
+        SolverConfig config;
+        config.findAll = true;
+        return config;
+    }
+};
+
+TEST_P(LearningTest, PlainSearchCount)
+{
+    EXPECT_EQ(countSolutions(GetParam().name, allSolutions()), GetParam().solutions);
+}
+
+TEST_P(LearningTest, NogoodLearningKeepsCount)
+{
+    SolverConfig config = allSolutions();
+    config.enableLearning = true;
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+}
+
+TEST_P(LearningTest, RestartsWithLearningKeepCount)
+{
+    // A short Luby unit, so the enumeration restarts many times
+    SolverConfig config = allSolutions();
+    config.enableLearning = true;
+    config.enableRestarts = true;
+    config.restartUnit = 4;
+    for (unsigned seed : {1u, 7u})
+    {
+        config.randomSeed = seed;
+        EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions) << "seed " << seed;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Samples, LearningTest, ::testing::ValuesIn(SAMPLE_COUNTS));
+
+TEST(RestartTest, FirstSolutionFoundWithRestarts)
+{
+    // Without --all, restarts run on the plain search
+    SolverConfig config;
+    config.enableRestarts = true;
+    config.restartUnit = 2;
+    EXPECT_EQ(countSolutions("8x8/example8x8_hard.txt", config), 1u);
+    EXPECT_EQ(countSolutions("example5x5_easy.txt", config), 0u);
+}
@@ -0,0 +1,96 @@
+#include "core/Grid.h"
+#include "solver/LocalRuleTable.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace slitherlink;
+
+namespace
+{
+    // Forced edges of one cell or point by brute force: every completion of
+    // the undecided edges (code 0) whose ON count is allowed, low nibble the
+    // edges ON in all of them, high nibble OFF in all of them
+    template <typename Allowed>
+    uint8_t bruteForce(unsigned key, Allowed &&allowed)
+    {
+        unsigned undecided = 0, on = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            unsigned code = (key >> (2 * i)) & 3;
+            undecided |= (code == 0) << i;
+            on |= (code == 1) << i;
+        }
+        unsigned alwaysOn = 0xF, alwaysOff = 0xF;
+        bool feasible = false;
+        for (unsigned pick = 0; pick < 16; ++pick)
+        {
+            if (pick & ~undecided)
+                continue;
+            unsigned edges = on | pick;
+            if (!allowed(__builtin_popcount(edges)))
+                continue;
+            feasible = true;
+            alwaysOn &= edges;
+            alwaysOff &= ~edges;
+        }
+        if (!feasible)
+            return LocalRules::CONFLICT;
+        return (uint8_t)((alwaysOn & undecided) | (alwaysOff & undecided) << 4);
+    }
+
+    // Keys without the unused code 3
+    bool validKey(unsigned key)
+    {
+        for (int i = 0; i < 4; ++i)
+            if (((key >> (2 * i)) & 3) == 3)
+                return false;
+        return true;
+    }
+} // namespace
+
+TEST(LocalRulesTest, CellTableMatchesBruteForce)
+{
+    for (int clue = 0; clue <= 3; ++clue)
+        for (unsigned key = 0; key < 256; ++key)
+            if (validKey(key))
+                EXPECT_EQ(LocalRules::cellRule(clue, key), bruteForce(key, [&](int on)
+                                                                      { return on == clue; }))
+                    << "clue " << clue << " key " << key;
+}
+
+TEST(LocalRulesTest, PointTableMatchesBruteForce)
+{
+    for (unsigned key = 0; key < 256; ++key)
+        if (validKey(key))
+            EXPECT_EQ(LocalRules::pointTable[key], bruteForce(key, [](int on)
+                                                              { return on == 0 || on == 2; }))
+                << "key " << key;
+}
+
+TEST(LocalRulesTest, PointKeyPadsMissingEdgesOff)
+{
+    // A border point with two edges: one ON forces the other ON
+    int list[2] = {0, 1};
+    unsigned key = LocalRules::key(list, 2, [](int e)
+                                   { return e == 0 ? 1 : 0; });
+    EXPECT_EQ(key, 0xA1u);
+    EXPECT_EQ(LocalRules::pointTable[key], 0x02);
+}
+
+TEST(LocalRulesTest, ClueOutsideTableConflicts)
+{
+    EXPECT_EQ(LocalRules::cellRule(4, 0), LocalRules::CONFLICT);
+    EXPECT_EQ(LocalRules::cellRule(-1, 0), LocalRules::CONFLICT);
+    EXPECT_EQ(LocalRules::cellRule(3, 256), LocalRules::CONFLICT);
+}
+
+TEST(LocalRulesTest, GridRejectsInvalidClues)
+{
+    Grid grid(2, 2);
+    EXPECT_THROW(grid.setClue(0, 0, 4), std::invalid_argument);
+    EXPECT_THROW(grid.setClue(0, 0, -2), std::invalid_argument);
+    grid.setClue(0, 0, 3);
+    grid.setClue(1, 1, -1);
+    EXPECT_EQ(grid.getClue(0, 0), 3);
+    EXPECT_EQ(grid.getClue(1, 1), -1);
+}
@@ -0,0 +1,151 @@
+#include "SolverTestUtil.h"
+#include "core/State.h"
+#include "solver/ParityEngine.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace slitherlink;
+using namespace slitherlink::test;
+
+namespace
+{
+    const int EDGES = 48;
+
+    // Random parity constraints of three to six edges each
+    struct RandomSystem
+    {
+        std::vector<std::vector<int>> supports;
+        std::vector<int> odd;
+
+        explicit RandomSystem(unsigned seed)
+        {
+            std::mt19937 rng(seed);
+            for (int c = 0; c < 36; ++c)
+            {
+                std::vector<int> support;
+                int size = 3 + (int)(rng() % 4);
+                while ((int)support.size() < size)
+                {
+                    int e = (int)(rng() % EDGES);
+                    if (std::find(support.begin(), support.end(), e) == support.end())
+                        support.push_back(e);
+                }
+                supports.push_back(support);
+                odd.push_back((int)(rng() % 2));
+            }
+        }
+    };
+
+    // Forced edges as (edge, value) in edge order
+    std::vector<std::pair<int, int>> forced(const ParityEngine &engine)
+    {
+        std::vector<std::pair<int, int>> units, out;
+        engine.units(units);
+        for (const auto &unit : units)
+            out.push_back({unit.first, engine.rowOdd(unit.second) ? 1 : -1});
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // A fresh engine synced once must agree with the incremental one
+    void expectMatchesFresh(const RandomSystem &system, ParityEngine &engine, const State &state)
+    {
+        ParityEngine fresh(system.supports, system.odd, EDGES);
+        bool ok = fresh.sync(state);
+        ASSERT_EQ(engine.sync(state), ok);
+        if (!ok)
+            return;
+        EXPECT_EQ(engine.getRank(), fresh.getRank());
+        EXPECT_EQ(forced(engine), forced(fresh));
+    }
+} // namespace
+
+TEST(ParityEngineTest, AbsorbAndPopRoundTrip)
+{
+    for (unsigned seed = 1; seed <= 20; ++seed)
+    {
+        RandomSystem system(seed);
+        ParityEngine engine(system.supports, system.odd, EDGES);
+        State state;
+        state.initialize(EDGES, 1, 1);
+        ParityEngine untouched = engine;
+        size_t rank = engine.getRank();
+
+        // Decide edges along the trail, backtrack part of the way, repeat
+        std::mt19937 rng(seed * 31);
+        for (int round = 0; round < 12; ++round)
+        {
+            for (int step = 0; step < 6; ++step)
+            {
+                int e = (int)(rng() % EDGES);
+                if (state.getEdgeState(e) != 0)
+                    continue;
+                state.setEdgeState(e, rng() % 2 ? 1 : -1);
+                state.pushTrail(e);
+                expectMatchesFresh(system, engine, state);
+            }
+            size_t keep = rng() % (state.getTrailSize() + 1);
+            while (state.getTrailSize() > keep)
+                state.setEdgeState(state.popTrail(), 0);
+            expectMatchesFresh(system, engine, state);
+        }
+
+        // Back to the empty assignment: the rows are as eliminated
+        while (state.getTrailSize() > 0)
+            state.setEdgeState(state.popTrail(), 0);
+        ASSERT_TRUE(engine.sync(state)) << "seed " << seed;
+        EXPECT_EQ(engine.getRank(), rank);
+        EXPECT_EQ(forced(engine), forced(untouched));
+    }
+}
+
+TEST(ParityEngineTest, SyncAcrossTrailOrigins)
+{
+    RandomSystem system(5);
+    ParityEngine engine(system.supports, system.odd, EDGES);
+    State state;
+    state.initialize(EDGES, 1, 1);
+    for (int e : {0, 7, 19})
+    {
+        state.setEdgeState(e, 1);
+        state.pushTrail(e);
+    }
+    expectMatchesFresh(system, engine, state);
+
+    // Decisions kept off the trail start a new origin
+    state.clearTrail();
+    state.setEdgeState(7, 0);
+    state.setEdgeState(30, -1);
+    state.pushTrail(30);
+    expectMatchesFresh(system, engine, state);
+
+    // A copy shares the origin, so its trail is compared entry by entry
+    State copy = state;
+    EXPECT_EQ(copy.getTrailOrigin(), state.getTrailOrigin());
+    copy.setEdgeState(copy.popTrail(), 0);
+    copy.setEdgeState(41, 1);
+    copy.pushTrail(41);
+    expectMatchesFresh(system, engine, copy);
+
+    // A state initialized anew never matches an earlier origin
+    State other;
+    other.initialize(EDGES, 1, 1);
+    EXPECT_NE(other.getTrailOrigin(), state.getTrailOrigin());
+    expectMatchesFresh(system, engine, other);
+}
+
+TEST(ParityEngineTest, LargeZeroGridSolvesWithParity)
+{
+    // Every clue 0 leaves no loop; the parity rows of a 120x120 grid used to
+    // be copied whole per absorbed edge and ran out of memory
+    Grid grid(120, 120);
+    for (int r = 0; r < 120; ++r)
+        for (int c = 0; c < 120; ++c)
+            grid.setClue(r, c, 0);
+    SolverConfig config;
+    config.parityInterval = 16;
+    EXPECT_EQ(countSolutions(grid, config), 0u);
+}
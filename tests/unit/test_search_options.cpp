@@ -0,0 +1,149 @@
+#include "SolverTestUtil.h"
+#include <gtest/gtest.h>
+
+using namespace slitherlink;
+using namespace slitherlink::test;
+
+// Extra propagation passes only deduce what the rules imply, and the other
+// heuristics, branching modes and engines only reorder the search: every
+// sample keeps the solution count of the plain search under each option,
+// and without --all each option stops at the hard 8x8's single solution
+class SearchOptionTest : public ::testing::TestWithParam<SampleCount>
+{
+protected:
+    static SolverConfig allSolutions()
+    {
+        SolverConfig config;
+        config.findAll = true;
+        return config;
+    }
+};
+
+static size_t firstSolutionsOfHard8x8(const SolverConfig &config)
+{
+    return countSolutions("8x8/example8x8_hard.txt", config);
+}
+
+TEST_P(SearchOptionTest, WindowConsistencyKeepsCount)
+{
+    SolverConfig config = allSolutions();
+    for (int k : {2, 3})
+    {
+        config.windowSize = k;
+        EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions) << "window " << k;
+    }
+}
+
+TEST(SearchOptionFirstSolution, WindowConsistency)
+{
+    SolverConfig config;
+    config.windowSize = 3;
+    EXPECT_EQ(firstSolutionsOfHard8x8(config), 1u);
+}
+
+TEST_P(SearchOptionTest, ImplicationGraphKeepsCount)
+{
+    SolverConfig config = allSolutions();
+    config.implicationInterval = 1;
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+}
+
+TEST(SearchOptionFirstSolution, ImplicationGraph)
+{
+    SolverConfig config;
+    config.implicationInterval = 1;
+    EXPECT_EQ(firstSolutionsOfHard8x8(config), 1u);
+}
+
+TEST_P(SearchOptionTest, ProbingKeepsCount)
+{
+    SolverConfig config = allSolutions();
+    config.probeDepth = 4;
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+}
+
+TEST(SearchOptionFirstSolution, Probing)
+{
+    SolverConfig config;
+    config.probeDepth = 4;
+    EXPECT_EQ(firstSolutionsOfHard8x8(config), 1u);
+}
+
+TEST_P(SearchOptionTest, ActivityHeuristicKeepsCount)
+{
+    SolverConfig config = allSolutions();
+    config.heuristic = "activity";
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+    config.heuristic = "smart";
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+}
+
+TEST(SearchOptionFirstSolution, ActivityHeuristic)
+{
+    SolverConfig config;
+    config.heuristic = "activity";
+    EXPECT_EQ(firstSolutionsOfHard8x8(config), 1u);
+}
+
+TEST_P(SearchOptionTest, PathEndHeuristicKeepsCount)
+{
+    SolverConfig config = allSolutions();
+    config.heuristic = "path";
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+}
+
+TEST(SearchOptionFirstSolution, PathEndHeuristic)
+{
+    SolverConfig config;
+    config.heuristic = "path";
+    EXPECT_EQ(firstSolutionsOfHard8x8(config), 1u);
+}
+
+TEST_P(SearchOptionTest, PatternBranchingKeepsCount)
+{
+    SolverConfig config = allSolutions();
+    config.branching = "pattern";
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+}
+
+TEST(SearchOptionFirstSolution, PatternBranching)
+{
+    SolverConfig config;
+    config.branching = "pattern";
+    EXPECT_EQ(firstSolutionsOfHard8x8(config), 1u);
+}
+
+TEST_P(SearchOptionTest, ColorEngineAndRaceKeepCount)
+{
+    SolverConfig config = allSolutions();
+    for (const char *engine : {"color", "race"})
+    {
+        config.engine = engine;
+        EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions) << engine;
+    }
+}
+
+TEST(SearchOptionFirstSolution, ColorEngineAndRace)
+{
+    SolverConfig config;
+    for (const char *engine : {"color", "race"})
+    {
+        config.engine = engine;
+        EXPECT_EQ(firstSolutionsOfHard8x8(config), 1u) << engine;
+    }
+}
+
+TEST(SearchOptionFirstSolution, RaceStoresOneSolution)
+{
+    // Both racers may finish at once; only the one claiming the stop stores
+    SolverConfig config;
+    config.engine = "race";
+    for (const char *heuristic : {"score", "activity"})
+    {
+        config.heuristic = heuristic;
+        for (const char *name : {"4x4/example4x4.txt", "example5x5_medium.txt", "6x6/example6x6_medium.txt"})
+            EXPECT_EQ(countSolutions(name, config), 1u) << name << " " << heuristic;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Samples, SearchOptionTest, ::testing::ValuesIn(SAMPLE_COUNTS));
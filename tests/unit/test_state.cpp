@@ -0,0 +1,241 @@
+#include "core/State.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace slitherlink;
+
+// A 4x4 grid: 40 edges, 25 points, 16 cells
+class PackedStateTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { state.initialize(40, 25, 16); }
+
+    State state;
+};
+
+TEST_F(PackedStateTest, BlockSizeCountsPackedBytes)
+{
+    // 2 words of edge codes; per score class one bitmap word, a size and
+    // a count per 64-edge word; a class byte per edge, 6 bytes per point
+    // (mate + counters + dirty + stale), 4 per cell (counters + dirty +
+    // stale), 7 per color slot (cells + outside)
+    size_t classes = State::SCORE_CLASSES * (8 + 4 + 1);
+    size_t bytes = 2 * 8 + classes + 40 + 6 * 25 + 4 * 16 + 7 * 17;
+    EXPECT_EQ(state.getBlockSize(), (bytes + State::CACHE_LINE - 1) / State::CACHE_LINE * State::CACHE_LINE);
+    EXPECT_EQ(state.getBlockSize() % State::CACHE_LINE, 0u);
+}
+
+TEST_F(PackedStateTest, EdgeCodesAreIndependent)
+{
+    for (int e = 0; e < 40; ++e)
+        state.setEdgeState(e, e % 3 == 0 ? 1 : e % 3 == 1 ? -1 : 0);
+    state.setEdgeState(31, 1); // last code of the first word
+    state.setEdgeState(32, -1);
+
+    std::vector<char> edges = state.getEdgeStates();
+    ASSERT_EQ(edges.size(), 40u);
+    for (int e = 0; e < 40; ++e)
+    {
+        char expected = e == 31 ? 1 : e == 32 ? -1 : e % 3 == 0 ? 1 : e % 3 == 1 ? -1 : 0;
+        EXPECT_EQ(edges[e], expected) << "edge " << e;
+        EXPECT_EQ(state.getEdgeState(e), expected) << "edge " << e;
+    }
+}
+
+TEST_F(PackedStateTest, ByteCountersRoundTrip)
+{
+    state.setPointUndecided(24, 4);
+    state.incrementPointDegree(24);
+    state.incrementPointDegree(24);
+    state.decrementPointUndecided(24);
+    EXPECT_EQ(state.getPointDegree(24), 2);
+    EXPECT_EQ(state.getPointUndecided(24), 3);
+    EXPECT_EQ(state.getPointDegree(23), 0);
+
+    state.setCellUndecided(15, 4);
+    state.incrementCellEdgeCount(15);
+    EXPECT_EQ(state.getCellEdgeCount(15), 1);
+    EXPECT_EQ(state.getCellUndecided(15), 4);
+}
+
+TEST_F(PackedStateTest, TrailPopRestoresEdges)
+{
+    std::vector<char> before = state.getEdgeStates();
+    size_t mark = state.getTrailSize();
+    for (int e : {3, 17, 32})
+    {
+        state.setEdgeState(e, 1);
+        state.pushTrail(e);
+    }
+    EXPECT_EQ(state.getTrailSize(), mark + 3);
+    EXPECT_EQ(state.getTrailAt(mark + 1), 17);
+
+    // Undo in reverse order, as Solver::undoDecisions does
+    std::vector<int> popped;
+    while (state.getTrailSize() > mark)
+    {
+        int e = state.popTrail();
+        popped.push_back(e);
+        state.setEdgeState(e, 0);
+    }
+    EXPECT_EQ(popped, (std::vector<int>{32, 17, 3}));
+    EXPECT_EQ(state.getEdgeStates(), before);
+}
+
+TEST_F(PackedStateTest, SegmentsLinkAndUnlink)
+{
+    // Points 0 - 1 - 2 along the top row
+    state.linkSegment(0, 1);
+    state.incrementPointDegree(0);
+    state.incrementPointDegree(1);
+    EXPECT_EQ(state.getOpenSegments(), 1);
+    EXPECT_EQ(state.getMate(0), 1);
+    EXPECT_EQ(state.getMate(1), 0);
+
+    state.linkSegment(1, 2);
+    state.incrementPointDegree(1);
+    state.incrementPointDegree(2);
+    EXPECT_EQ(state.getOpenSegments(), 1);
+    EXPECT_EQ(state.getMate(0), 2);
+    EXPECT_EQ(state.getMate(2), 0);
+
+    state.unlinkSegment();
+    state.decrementPointDegree(1);
+    state.decrementPointDegree(2);
+    EXPECT_EQ(state.getMate(0), 1);
+    EXPECT_EQ(state.getMate(1), 0);
+
+    state.unlinkSegment();
+    EXPECT_EQ(state.getOpenSegments(), 0);
+    EXPECT_EQ(state.getClosedLoops(), 0);
+}
+
+TEST_F(PackedStateTest, ColorMergesUndoByTrailMark)
+{
+    int parity = 0;
+    state.mergeColors(0, 1, 1);
+    state.pushTrail(0);
+    int root = state.findColor(0, parity);
+    state.mergeColors(root, state.findColor(2, parity), 0);
+
+    int parity0 = 0, parity1 = 0, parity2 = 0;
+    EXPECT_EQ(state.findColor(0, parity0), state.findColor(1, parity1));
+    EXPECT_EQ(state.findColor(0, parity0), state.findColor(2, parity2));
+    EXPECT_NE(parity0, parity1);
+
+    state.undoColors(0); // the merge after the push goes
+    EXPECT_NE(state.findColor(0, parity0), state.findColor(2, parity2));
+    EXPECT_EQ(state.findColor(0, parity0), state.findColor(1, parity1));
+
+    state.undoColorMerges(0);
+    EXPECT_NE(state.findColor(0, parity0), state.findColor(1, parity1));
+    EXPECT_EQ(state.getColorSetSize(state.findColor(0, parity0)), 1);
+}
+
+TEST_F(PackedStateTest, CopyIsIndependent)
+{
+    state.setEdgeState(5, 1);
+    state.pushTrail(5);
+    State copy = state;
+    copy.setEdgeState(6, -1);
+
+    EXPECT_EQ(copy.getEdgeState(5), 1);
+    EXPECT_EQ(copy.getTrailSize(), 1u);
+    EXPECT_EQ(state.getEdgeState(6), 0);
+    EXPECT_EQ(copy.getBlockSize(), state.getBlockSize());
+}
+
+TEST(StateBlockTest, MovesKeepInlineAndAllocatedBlocks)
+{
+    // A 4x4 grid's block lives in the State, a 20x20 grid's is allocated
+    EXPECT_LE(State::blockBytes(40, 25, 16), State::INLINE_BYTES);
+    EXPECT_GT(State::blockBytes(840, 441, 400), State::INLINE_BYTES);
+    for (auto counts : {std::vector<size_t>{40, 25, 16}, std::vector<size_t>{840, 441, 400}})
+    {
+        State source;
+        source.initialize(counts[0], counts[1], counts[2]);
+        source.setEdgeState(5, 1);
+        source.setPointDegree(3, 2);
+
+        State moved(std::move(source));
+        State assigned;
+        assigned = std::move(moved);
+        EXPECT_EQ(assigned.getBlockSize(), State::blockBytes(counts[0], counts[1], counts[2]));
+        EXPECT_EQ(assigned.getEdgeState(5), 1);
+        EXPECT_EQ(assigned.getPointDegree(3), 2);
+        assigned.setEdgeState(6, -1);
+        EXPECT_EQ(assigned.getEdgeState(6), -1);
+    }
+}
+
+TEST(ScoreClassTest, FirstInClassFollowsScanOrderFromStart)
+{
+    // 200 edges span four 64-edge words
+    State state;
+    state.initialize(200, 100, 50);
+    EXPECT_EQ(state.getBestClass(), -1);
+    for (int e : {5, 70, 130, 190})
+        state.fileEdge(e, 3);
+    state.fileEdge(100, 7);
+    EXPECT_EQ(state.getBestClass(), 3);
+
+    EXPECT_EQ(state.firstInClass(3, 0), 5);
+    EXPECT_EQ(state.firstInClass(3, 5), 5);
+    EXPECT_EQ(state.firstInClass(3, 6), 70);
+    EXPECT_EQ(state.firstInClass(3, 131), 190);
+    EXPECT_EQ(state.firstInClass(3, 191), 5); // wraps around
+    EXPECT_EQ(state.firstInClass(7, 150), 100);
+    EXPECT_EQ(state.firstInClass(2, 0), -1);
+
+    // Moving and removing edges keeps the counts and the best class
+    state.fileEdge(70, 7);
+    state.fileEdge(5, -1);
+    EXPECT_EQ(state.getEdgeClass(5), -1);
+    EXPECT_EQ(state.getEdgeClass(70), 7);
+    EXPECT_EQ(state.firstInClass(3, 0), 130);
+    EXPECT_EQ(state.firstInClass(3, 191), 130);
+    state.fileEdge(130, -1);
+    state.fileEdge(190, -1);
+    EXPECT_EQ(state.getBestClass(), 7);
+    EXPECT_EQ(state.firstInClass(7, 101), 70);
+
+    State copy = state;
+    copy.fileEdge(70, 1);
+    EXPECT_EQ(copy.getBestClass(), 1);
+    EXPECT_EQ(state.getBestClass(), 7);
+}
+
+TEST(ScoreClassTest, CounterChangesMarkPointsAndCellsStale)
+{
+    State state;
+    state.initialize(40, 25, 16);
+    int points = 0;
+    while (state.hasStalePoints())
+        points += state.takeStalePoint() >= 0;
+    EXPECT_EQ(points, 25); // a fresh state is all stale
+    EXPECT_FALSE(state.hasStaleCells());
+
+    state.setPointUndecided(3, 4);
+    state.setCellUndecided(2, 4);
+    EXPECT_FALSE(state.hasStalePoints()); // setup does not mark
+    state.decrementPointUndecided(3);
+    state.incrementPointUndecided(3);
+    state.decrementCellUndecided(2);
+    ASSERT_TRUE(state.hasStalePoints());
+    EXPECT_EQ(state.takeStalePoint(), 3);
+    EXPECT_FALSE(state.hasStalePoints()); // marked once
+    ASSERT_TRUE(state.hasStaleCells());
+    EXPECT_EQ(state.takeStaleCell(), 2);
+}
+
+TEST(StateLimitsTest, RejectsCountsBeyondSixteenBitIndices)
+{
+    // 180x180 still fits: 32761 points, 32400 cells
+    State fits;
+    EXPECT_NO_THROW(fits.initialize(2 * 180 * 181, 181 * 181, 180 * 180));
+
+    // 181x181 has 33124 points
+    State tooLarge;
+    EXPECT_THROW(tooLarge.initialize(2 * 181 * 182, 182 * 182, 181 * 181), std::length_error);
+}
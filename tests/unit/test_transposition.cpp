@@ -0,0 +1,112 @@
+#include "SolverTestUtil.h"
+#include "solver/TranspositionTable.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace slitherlink;
+using namespace slitherlink::test;
+
+TEST(TranspositionTableTest, CapacityIsPowerOfTwoWithinBudget)
+{
+    TranspositionTable table(1000);
+    // 4-way buckets of 8-byte slots: 31 buckets fit, 16 are used
+    EXPECT_EQ(table.getCapacity(), 16u * 4);
+    EXPECT_LE(table.getBytes(), 1000u);
+
+    TranspositionTable tiny(0);
+    EXPECT_EQ(tiny.getCapacity(), 4u); // at least one bucket
+}
+
+TEST(TranspositionTableTest, CountsHitsAndMisses)
+{
+    TranspositionTable table(1 << 12);
+    EXPECT_FALSE(table.probe(0x1234));
+    table.store(0x1234);
+    table.store(0x1234); // already present: not stored twice
+    EXPECT_TRUE(table.probe(0x1234));
+    EXPECT_FALSE(table.probe(0x5678));
+
+    EXPECT_EQ(table.getHits(), 1);
+    EXPECT_EQ(table.getMisses(), 2);
+    EXPECT_EQ(table.getStores(), 1);
+
+    table.clear();
+    EXPECT_FALSE(table.probe(0x1234));
+    EXPECT_EQ(table.getHits(), 0);
+    EXPECT_EQ(table.getStores(), 0);
+}
+
+TEST(TranspositionTableTest, ZeroHashIsNeverStored)
+{
+    TranspositionTable table(1 << 12);
+    table.store(0);
+    EXPECT_FALSE(table.probe(0));
+    EXPECT_EQ(table.getStores(), 0);
+}
+
+TEST(TranspositionTableTest, FullBucketEvictsOneEntry)
+{
+    // A single bucket: the fifth hash replaces one of the first four
+    TranspositionTable table(0);
+    for (uint64_t h = 1; h <= 5; ++h)
+        table.store(h << 8);
+    int present = 0;
+    for (uint64_t h = 1; h <= 5; ++h)
+        present += table.probe(h << 8);
+    EXPECT_EQ(present, 4);
+    EXPECT_TRUE(table.probe(5 << 8));
+}
+
+TEST(TranspositionTableTest, ConcurrentWritersKeepWholeEntries)
+{
+    // Threads race on a small table. Whatever survives must be a hash some
+    // writer stored (never a torn or foreign value), and a table large
+    // enough for everything must keep every entry
+    const int threads = 4, perThread = 2000;
+    auto hashOf = [](int t, int i) { return (uint64_t(t + 1) << 40) | uint64_t(i + 1) * 0x9E3779B1u; };
+
+    for (size_t budget : {size_t(256), size_t(1) << 20})
+    {
+        TranspositionTable table(budget);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t)
+            writers.emplace_back([&, t]()
+                                 {
+                                     for (int i = 0; i < perThread; ++i)
+                                     {
+                                         table.store(hashOf(t, i));
+                                         table.probe(hashOf(t, i));
+                                     } });
+        for (auto &w : writers)
+            w.join();
+
+        EXPECT_EQ(table.getHits() + table.getMisses(), threads * perThread);
+        EXPECT_FALSE(table.probe(0xDEADBEEF));
+        long long found = 0;
+        for (int t = 0; t < threads; ++t)
+            for (int i = 0; i < perThread; ++i)
+                found += table.probe(hashOf(t, i));
+        if (budget > (size_t(1) << 16))
+            EXPECT_EQ(found, threads * perThread);
+        else
+            EXPECT_LE(found, (long long)table.getCapacity());
+    }
+}
+
+// Dead-subtree cuts never lose a solution, under the parallel search too
+class TranspositionSearchTest : public ::testing::TestWithParam<SampleCount>
+{
+};
+
+TEST_P(TranspositionSearchTest, KeepsSolutionCount)
+{
+    SolverConfig config;
+    config.findAll = true;
+    config.ttBudgetMB = 1;
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+    config.threads = 4;
+    EXPECT_EQ(countSolutions(GetParam().name, config), GetParam().solutions);
+}
+
+INSTANTIATE_TEST_SUITE_P(Samples, TranspositionSearchTest, ::testing::ValuesIn(SAMPLE_COUNTS));